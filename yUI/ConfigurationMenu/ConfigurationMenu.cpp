@@ -61,5 +61,7 @@ namespace ConfigurationMenu
 		
 		deferredInit.emplace_back(DeferredInit);
 		mainLoop.emplace_back(MainLoop);
+		mainLoop.emplace_back(UpdateINI);
+		exitGame.emplace_back(FlushINI);
 	}
 }
@@ -7,6 +7,9 @@
 void WriteMCMHooks();
 void MainLoop();
 
+void FlushINI();
+void UpdateINI();
+
 class CMMCMMod;
 class CMMCMItem;
 class JSON;
@@ -233,16 +236,10 @@ public:
 			std::string category;
 			std::string setting;
 
-			bool operator <(const INI& rhs) const
-			{
-				if (file != rhs.file)
-					return file < rhs.file;
-
-				if (category != rhs.category)
-					return category < rhs.category;
+			UInt64 id = 0;	// file, category and setting interned and packed, 0 when any of them is empty
 
-				return setting < rhs.setting;
-			}
+			INI() = default;
+			INI(std::filesystem::path file, std::string category, std::string setting);
 		};
 
 		class MCM
@@ -544,6 +541,10 @@ public:
 
 	std::set<std::unique_ptr<CMSetting>>				setSettings;
 
+	// settings by mod, each mod's settings in one vector; rebuilt on the first lookup after AddSetting
+	std::unordered_map<std::string, std::vector<CMSetting*>>	settingsByMod;
+	bool														settingsIndexed = false;
+
 	CMTag* tagDefault = nullptr;
 
 	class SettingList
@@ -756,7 +757,10 @@ public:
 	void Device();
 	void Default();
 
-	std::vector<CMSetting*> GetSettingsForString(std::string str);
+	void AddSetting(std::unique_ptr<CMSetting> setting);
+	void IndexSettings();
+
+	const std::vector<CMSetting*>& GetSettingsForString(const std::string& str);
 
 	void DisplaySettings(std::string id);
 
@@ -104,6 +104,8 @@ void ModConfigurationMenu::Close()
 
 	Menu::Close();
 
+	FlushINI();
+
 	*(UInt8*)0x119F348 = 1;
 
 	StartMenu::GetSingleton()->tileMainTitle->SetGradual(kTileValue_alpha, 0, 255, 0.25);
@@ -420,7 +420,7 @@ void ModConfigurationMenu::ReadMCM()
 		const auto tag = CMCategory(mod);
 		mapCategories.emplace(tag.id, std::make_unique<CMCategory>(tag));
 
-		setSettings.emplace(std::make_unique<CMSettingCategory>(mod));
+		AddSetting(std::make_unique<CMSettingCategory>(mod));
 	}
 
 	for (const auto& [mod, val] : items)
@@ -453,7 +453,7 @@ void ModConfigurationMenu::ReadMCM()
 		//if (elem.contains("category"))		setting = std::make_unique<CMSettingCategory>(item);
 //		else if (elem.contains("font"))		setting = std::make_unique<CMSettingFont>(item);
 
-		setSettings.emplace(std::move(setting));
+		AddSetting(std::move(setting));
 	}
 
 	doonce2++;
@@ -1,19 +1,77 @@
 #pragma once
 #include "ConfigurationMenu.h"
-#include <SimpleINILibrary.h>
+#include "ConfigurationMenuINIDocument.h"
 
 #include "GameData.h"
 #include "TESForm.h"
 #include "InterfaceManager.h"
 #include "Setting.h"
 
-inline std::map<CMSetting::IO::INI, CMValue> ini_map;
+// file, category and setting names share one table of dense IDs, a value is stored under the three packed together
+inline std::unordered_map<std::string, UInt32> ini_names;
+inline std::unordered_map<UInt64, CMValue> ini_values;
+
+inline UInt64 InternININame(const std::string& name)
+{
+	return ini_names.emplace(name, ini_names.size() + 1).first->second;
+}
+
+CMSetting::IO::INI::INI(std::filesystem::path file, std::string category, std::string setting)
+	: file(std::move(file)), category(std::move(category)), setting(std::move(setting))
+{
+	if (this->file.empty() || this->category.empty() || this->setting.empty()) return;
+	id = InternININame(this->file.string()) << 42 | InternININame(this->category) << 21 | InternININame(this->setting);
+}
+
+inline std::map<std::filesystem::path, std::unique_ptr<INIDocument>> ini_documents;
+
+constexpr UInt32 kINIFlushDelay = 1000;
+
+inline INIDocument* GetINIDocument(const std::filesystem::path& iniPath)
+{
+	if (const auto iter = ini_documents.find(iniPath); iter != ini_documents.end()) return iter->second.get();
+
+	auto document = std::make_unique<INIDocument>();
+	document->ini.SetUnicode();
+	if (document->ini.LoadFile(iniPath.c_str()) == SI_FILE) return nullptr;
+
+	return ini_documents.emplace(iniPath, std::move(document)).first->second.get();
+}
+
+inline void MarkINIDirty(INIDocument* document)
+{
+	document->dirty = true;
+	document->lastWrite = GetTickCount();
+}
+
+inline void FlushINIDocument(const std::filesystem::path& iniPath, INIDocument* document)
+{
+	std::string error;
+	if (FlushINIDocument(iniPath, *document, error) || error.empty()) return;
+
+	// wait out another debounce before retrying, rather than failing again every frame
+	document->lastWrite = GetTickCount();
+	Log(g_LogLevel) << "Configuration Menu: " + error;
+}
+
+void FlushINI()
+{
+	for (const auto& [iniPath, document] : ini_documents) FlushINIDocument(iniPath, document.get());
+}
+
+void UpdateINI()
+{
+	for (const auto& [iniPath, document] : ini_documents)
+		if (document->dirty && GetTickCount() - document->lastWrite >= kINIFlushDelay) FlushINIDocument(iniPath, document.get());
+}
 
 inline void ReadINIInternal(const std::filesystem::path& iniPath, const std::filesystem::path& iniPath2)
 {
-	CSimpleIniA ini;
-	ini.SetUnicode();
-	if (ini.LoadFile(iniPath.c_str()) == SI_FILE) return;
+	const auto document = GetINIDocument(iniPath);
+	if (!document || document->read) return;
+	document->read = true;
+
+	auto& ini = document->ini;
 
 	CSimpleIniA::TNamesDepend sections;
 	ini.GetAllSections(sections);
@@ -30,20 +88,20 @@ inline void ReadINIInternal(const std::filesystem::path& iniPath, const std::fil
 			else if (key.pItem[0] == 'f') value = ini.GetDoubleValue(section.pItem, key.pItem);
 			else if (key.pItem[0] == 's') value = static_cast<std::string>(ini.GetValue(section.pItem, key.pItem));
 
-			CMSetting::IO::INI ini1{ iniPath2, section.pItem, key.pItem };
-
-			ini_map.emplace(ini1, value);
+			ini_values.emplace(CMSetting::IO::INI(iniPath2, section.pItem, key.pItem).id, value);
 		}
 	}
 
-	ini.SaveFile(iniPath.c_str(), false);
+	// the file used to be saved back right after reading, which normalizes its formatting
+	MarkINIDirty(document);
 }
 
 inline void WriteINIInternal(const std::filesystem::path& iniPath, const CMSetting::IO::INI& setting, const CMValue& value)
 {
-	CSimpleIniA ini;
-	ini.SetUnicode();
-	if (ini.LoadFile(iniPath.c_str()) == SI_FILE) return;
+	const auto document = GetINIDocument(iniPath);
+	if (!document) return;
+
+	auto& ini = document->ini;
 
 	if (value.IsString())
 		ini.SetValue(setting.category.c_str(), setting.setting.c_str(), static_cast<std::string>(value).c_str());
@@ -52,36 +110,34 @@ inline void WriteINIInternal(const std::filesystem::path& iniPath, const CMSetti
 	else if (value.IsInteger())
 		ini.SetLongValue(setting.category.c_str(), setting.setting.c_str(), value);
 
-	ini.SaveFile(iniPath.c_str(), false);
+	MarkINIDirty(document);
 }
 
 std::optional<CMValue> CMSetting::IO::ReadINI()
 {
-	if (ini.file.empty() || ini.category.empty() || ini.setting.empty()) return {};
+	if (!ini.id) return {};
+
+	if (const auto iter = ini_values.find(ini.id); iter != ini_values.end()) return iter->second;
 
 	std::filesystem::path iniPath = GetCurPath();
 	iniPath += ini.file;
 
-	const auto settingTuple = ini;
-
-	if (ini_map.contains(settingTuple)) return ini_map[settingTuple];
-
 	ReadINIInternal(iniPath, ini.file);
 
-	if (ini_map.contains(settingTuple)) return ini_map[settingTuple];
+	if (const auto iter = ini_values.find(ini.id); iter != ini_values.end()) return iter->second;
 
 	return {};
 }
 
 void CMSetting::IO::WriteINI(const CMValue& value) const
 {
-	if (ini.file.empty() || ini.category.empty() || ini.setting.empty()) return;
+	if (!ini.id) return;
+
+	ini_values[ini.id] = value;
 
 	std::filesystem::path iniPath = GetCurPath();
 	iniPath += ini.file;
 
-	ini_map[ini] = value;
-
 	WriteINIInternal(iniPath, ini, value);
 }
 
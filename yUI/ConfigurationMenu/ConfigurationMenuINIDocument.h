@@ -0,0 +1,44 @@
+#pragma once
+#include <SimpleINILibrary.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// the parsed file stays in memory and is the authority for it, writes are coalesced until FlushINI or the debounce
+struct INIDocument
+{
+	CSimpleIniA	ini;
+	bool		read		= false;	// ini_values holds every value of the file
+	bool		dirty		= false;
+	UInt32		lastWrite	= 0;
+};
+
+// saves next to the file and renames over it, so a crash mid-write never leaves a truncated INI
+// the document only turns clean once the rename went through, a failed flush is retried by the next one
+inline bool FlushINIDocument(const std::filesystem::path& iniPath, INIDocument& document, std::string& error)
+{
+	if (!document.dirty) return false;
+
+	auto tempPath = iniPath;
+	tempPath += ".tmp";
+
+	// SaveFile skips writing narrow paths when only strings changed, the buffer is always complete
+	std::string buffer;
+	if (document.ini.Save(buffer, false) < 0 || !(std::ofstream(tempPath, std::ios::binary | std::ios::trunc) << buffer))
+	{
+		error = "failed to write " + iniPath.string();
+		return false;
+	}
+
+	std::error_code code;
+	std::filesystem::rename(tempPath, iniPath, code);
+	if (code)
+	{
+		error = "failed to replace " + iniPath.string() + ": " + code.message();
+		return false;
+	}
+
+	document.dirty = false;
+	return true;
+}
@@ -176,7 +176,7 @@ void ModConfigurationMenu::ReadJSON(const std::filesystem::path& path)
 			else if (elem.contains("font"))		setting = std::make_unique<CMSettingFont>(JSON(elem));
 			else								setting = std::make_unique<CMSetting>(JSON(elem));
 
-			setSettings.emplace(std::move(setting));
+			AddSetting(std::move(setting));
 		}
 
 		for (const auto& iter : setSettings) iter->SetID();
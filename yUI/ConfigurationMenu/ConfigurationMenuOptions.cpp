@@ -586,16 +586,38 @@ void ModConfigurationMenu::Default()
 	}
 }
 
-std::vector<CMSetting*> ModConfigurationMenu::GetSettingsForString(std::string str)
+void ModConfigurationMenu::AddSetting(std::unique_ptr<CMSetting> setting)
 {
-	std::vector<CMSetting*> ret;
+	setSettings.emplace(std::move(setting));
+	settingsIndexed = false;
+}
+
+void ModConfigurationMenu::IndexSettings()
+{
+	if (settingsIndexed) return;
+	settingsIndexed = true;
+
+	settingsByMod.clear();
+
 	for (const auto& setting : setSettings)
 	{
-		if (str.empty() && setting->mods.empty()) {}
-		else if (!setting->mods.contains(str)) continue;
-		ret.push_back(setting.get());
+		// settings without a mod are listed under the empty string
+		if (setting->mods.empty()) settingsByMod[""].push_back(setting.get());
+		for (const auto& mod : setting->mods) settingsByMod[mod].push_back(setting.get());
 	}
-	return ret;
+}
+
+static const std::vector<CMSetting*>& FindSettings(const std::unordered_map<std::string, std::vector<CMSetting*>>& index, const std::string& key)
+{
+	static const std::vector<CMSetting*> empty;
+	const auto iter = index.find(key);
+	return iter != index.end() ? iter->second : empty;
+}
+
+const std::vector<CMSetting*>& ModConfigurationMenu::GetSettingsForString(const std::string& str)
+{
+	IndexSettings();
+	return FindSettings(settingsByMod, str);
 }
 
 void ModConfigurationMenu::SettingList::UpdateTagString()
@@ -1,6 +1,9 @@
 #pragma once
 #include <Menu.h>
 
+// counts how often every item rule is evaluated and logs the totals after each game load
+#define SI_RULE_STATS 0
+
 namespace SortingIcons
 {
 	class Tab;
@@ -13,6 +16,13 @@ namespace SortingIcons
 	inline int bHotkeys			= 1;
 	inline int bCategories		= 1;
 	inline int bPrompt			= 1;
+	inline int bBenchmark		= 0;
+	inline int bHotReload		= 0;
+	inline int bReorderRules	= 0;
+	inline int bPruneRules		= 0;
+	inline int bAnalyzeRules	= 0;
+
+	inline int iCacheSize		= 8192;
 
 	namespace Files
 	{
@@ -24,6 +34,10 @@ namespace SortingIcons
 	public:
 		std::string		tag;
 		SInt32			priority = 0;
+		UInt32			tagID = 0;		// interned tag, IDs follow alphabetical order of tags
+
+		std::string		file;			// rule file this came from
+		UInt32			fileIndex = 0;	// position in that file, breaks priority ties
 
 		Object(const Files::JSON& elem);
 
@@ -33,7 +47,7 @@ namespace SortingIcons
 		{
 			if (!lhs) return -1;
 			if (!rhs) return 1;
-			return (lhs->tag <=> rhs->tag)._Value;
+			return (lhs->tagID <=> rhs->tagID)._Value;
 		}
 	};
 
@@ -48,12 +62,35 @@ namespace SortingIcons
 		std::optional<bool>					miscProduct;
 
 	public:
+		UInt32								index = 0;
+		std::string							source;		// rule as written, only kept for hot reload
+		UInt64								keyrings = 0;	// keyrings whose categories include this tag, bit per g_Keyrings index
+		UInt64								tabs = 0;		// tabs whose categories include this tag, bit per g_Tabline index
+		UInt32								hits = 0;		// forms this rule was the first match for
+#if SI_RULE_STATS
+		UInt32								evaluations = 0;
+#endif
+
 		Item(const Files::JSON& elem);
 
 		bool IsValid() const override;
 		bool Satisfies(TESForm* form) const override;
+		virtual bool Narrows() const { return false; }	// checks more than formIDs, formType and the flags above
+		bool Covers(const Item* other) const;
+		bool Excludes(const Item* other) const;
+		bool Commutes(const Item* other) const;
+		std::string CheckConditions() const;
+
+		static void BuildIndex();
+		static void Reorder();
+		static void DumpStats();
+		static void ResetStats();
+		static UInt32 Invalidate(const std::unordered_set<const Item*>& removed, const std::string& file, const std::vector<Item*>& added);
+
+		static void ClearCache();
 
 		static Item* Set(TESForm* form, Item* item);
+		static void Override(TESForm* form, Item* item);
 		static Item* Get(TESForm* form);
 	};
 
@@ -82,6 +119,7 @@ namespace SortingIcons
 		Weapon(const Files::JSON& elem);
 
 		bool Satisfies(TESForm* form) const override;
+		bool Narrows() const override;
 	};
 
 	class Armor : public Item
@@ -101,6 +139,7 @@ namespace SortingIcons
 		Armor(const Files::JSON& elem);
 
 		bool Satisfies(TESForm* form) const override;
+		bool Narrows() const override;
 	};
 
 	class Aid : public Item
@@ -117,6 +156,7 @@ namespace SortingIcons
 		Aid(const Files::JSON& elem);
 
 		bool Satisfies(TESForm* form) const override;
+		bool Narrows() const override;
 	};
 
 	class Category : public Object
@@ -126,6 +166,7 @@ namespace SortingIcons
 
 		std::unordered_set<UInt32>			types;
 		std::unordered_set<std::string>		categories;
+		std::vector<bool>					categoryIDs;
 
 		UInt32			tabNew = 0;
 		UInt32			tabMisc = 0;
@@ -135,8 +176,11 @@ namespace SortingIcons
 		virtual bool IsKey() { return false; }
 		virtual bool IsInventory() { return false; }
 
+		bool SatisfiesType(UInt8 typeID) const;
 		bool SatisfiesForm(TESForm* form) const;
-		bool SatisfiesTag(std::string tag) const;
+		bool SatisfiesTag(UInt32 tagID) const;
+
+		void InternTags(const std::unordered_map<std::string, UInt32>& tagIDs);
 
 		bool Satisfies(TESForm* form) const override;
 	};
@@ -199,13 +243,32 @@ namespace SortingIcons
 	inline std::vector<std::unique_ptr<Category>>	g_Categories;
 	inline std::vector<std::unique_ptr<Icon>>		g_Icons;
 
-	inline std::unordered_map<std::string, Tab*>		g_StringToTabs;
+	// icon file name in lower case to the atlas it was packed into, filled from the "atlas" section the packer writes
+	inline std::unordered_map<std::string, std::string>	g_IconToAtlas;
+
+	inline std::vector<Tab*>							g_TagToTab;
+	inline std::vector<Icon*>							g_TagToIcon;
 
 	inline std::vector<Keyring*>						g_Keyrings;
 	inline std::vector<Tab*>							g_Tabline;
 	inline std::vector<std::filesystem::path>							g_XMLPaths;
 }
 
+namespace SortingIcons::Keyrings
+{
+	void BuildMasks();
+}
+
+namespace SortingIcons::Tabs
+{
+	void BuildMasks();
+}
+
+namespace SortingIcons::Sorting
+{
+	void Sort(std::vector<InventoryChanges*>& entries);
+}
+
 namespace SortingIcons::Commands
 {
 	void Register();
@@ -213,7 +276,8 @@ namespace SortingIcons::Commands
 
 namespace SortingIcons::Files
 {
-	void HandleJSON(const std::filesystem::path& path);
+	void HandleJSON(std::vector<std::filesystem::path> paths);
+	bool HandleJSON(const std::filesystem::path& path);
 	void HandleXML(const std::filesystem::path& path);
 }
 
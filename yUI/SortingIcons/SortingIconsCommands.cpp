@@ -39,9 +39,13 @@ namespace SortingIcons::Commands
 		if (!form) return true;
 		const auto tochange = std::string(src);
 		if (tochange == "category" || tochange == "tag" || tochange == "string")
-			AssignString(PASS_COMMAND_ARGS, Item::Get(form)->tag.c_str());
+		{
+			if (const auto item = Item::Get(form)) AssignString(PASS_COMMAND_ARGS, item->tag.c_str());
+		}
 		else if (tochange == "icon" || tochange == "filename")
-			AssignString(PASS_COMMAND_ARGS, Icon::Get(Item::Get(form))->filename.c_str());
+		{
+			if (const auto icon = Icon::Get(Item::Get(form))) AssignString(PASS_COMMAND_ARGS, icon->filename.c_str());
+		}
 		return true;
 	}
 
@@ -56,9 +60,8 @@ namespace SortingIcons::Commands
 		if (!form) return true;
 		const auto tochange = std::string(src);
 		if (tochange == "tag" || tochange == "string") {
-			for (const auto& iter : g_Items)
-				if (iter->tag == tochange)
-					Item::Set(form, iter.get());
+			if (const auto iter = ra::find_if(g_Items, [&](const auto& item) { return item->tag == newstring; }); iter != g_Items.end())
+				Item::Override(form, iter->get());
 			*result = 1;
 		}
 		else if (tochange == "icon" || tochange == "filename") {
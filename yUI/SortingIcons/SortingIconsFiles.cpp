@@ -1,25 +1,61 @@
 #include "SortingIcons.h"
+#include "SortingIconsLists.h"
+#include "SortingIconsStream.h"
 
 #include <GameData.h>
 #include <json.h>
 
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 using namespace SortingIcons;
 using namespace Files;
 
 class Files::JSON : public nlohmann::basic_json<> {};
 
-__forceinline std::vector<TESForm*> GetFormsFromElement(const nlohmann::basic_json<>& mod, const nlohmann::basic_json<>& form)
+// mod name -> load order index, every distinct name is looked up in the data handler once per session
+std::unordered_map<std::string, UInt8> g_ModIndices;
+
+UInt8 GetModIndex(const std::string& modName)
+{
+	const auto [iter, inserted] = g_ModIndices.try_emplace(modName, 0xFF);
+	if (inserted) iter->second = TESDataHandler::GetSingleton()->GetModIndex(modName.c_str());
+	return iter->second;
+}
+
+// hex form IDs resolve through the cached mod index, anything else goes through the game's own lookup
+TESForm* ResolveForm(const std::string& modName, UInt8 modIndex, const std::string& formID)
 {
-	const auto modName = mod.get<std::string>();
+	UInt32 refID = 0;
+	const auto end = formID.data() + formID.size();
+	if (const auto [ptr, error] = std::from_chars(formID.data(), end, refID, 16); error != std::errc() || ptr != end)
+		return TESForm::GetByID(modName.c_str(), formID.c_str());
+	if (modIndex == 0xFF) return nullptr;
+	return TESForm::GetByID(static_cast<UInt32>(modIndex) << 24 | refID & 0x00FFFFFF);
+}
+
+std::vector<TESForm*> GetFormsFromElement(const nlohmann::basic_json<>& mod, const nlohmann::basic_json<>& form)
+{
+	const auto& modName = mod.get_ref<const std::string&>();
+	const auto modIndex = GetModIndex(modName);
+
 	std::vector<TESForm*> forms{};
 	std::string log;
-	if (!form.is_array()) {
-		if (const auto val = TESForm::GetByID(modName.c_str(), form.get<std::string>().c_str())) forms.push_back(val);
-		else log += (!log.empty() ? ", " : "") + std::format("{:6s}", form.get<std::string>());
-	}
-	else for (const auto& i : form) {
-		if (const auto val = TESForm::GetByID(modName.c_str(), i.get<std::string>().c_str())) forms.push_back(val);
-		else log += (!log.empty() ? ", " : "") + std::format("{:6s}", i.get<std::string>());
+	const auto resolve = [&](const nlohmann::basic_json<>& elem)
+	{
+		const auto& formID = elem.get_ref<const std::string&>();
+		if (const auto val = ResolveForm(modName, modIndex, formID)) forms.push_back(val);
+		else log += (!log.empty() ? ", " : "") + std::format("{:6s}", formID);
+	};
+
+	if (!form.is_array()) resolve(form);
+	else
+	{
+		forms.reserve(form.size());
+		for (const auto& i : form) resolve(i);
 	}
 	if (!log.empty()) Log(logLevel) << "JSON warning: Failed to find form, mod: " + modName + ", forms: " + log;
 	return forms;
@@ -33,33 +69,46 @@ template <typename T> std::vector<T> GetSetFromElement(const nlohmann::basic_jso
 	return set;
 }
 
-std::vector<UInt32> FlattenListForm(TESForm* form)
+struct ListFormTraits
 {
-	std::vector<UInt32> output;
-	if (form->typeID != kFormType_BGSListForm)
-		output.push_back(form->refID);
-	else for (const auto iter : reinterpret_cast<BGSListForm*>(form)->list)
-		for (const auto val : FlattenListForm(iter)) output.push_back(val);
-	return output;
-}
+	using List = BGSListForm;
 
-std::vector<UInt32> FlattenListRepair(TESForm* form)
-{
-	std::vector<UInt32> output;
-	output.push_back(form->refID);
-	for (const auto item : *TESForm::GetAll())
+	static UInt32 GetID(const BGSListForm* list) { return list->refID; }
+
+	template <typename F> static void ForEach(BGSListForm* list, F&& visit)
 	{
-		BGSListForm* list;
+		for (const auto iter : list->list)
+			if (iter) visit(iter->refID, iter->typeID == kFormType_BGSListForm ? reinterpret_cast<BGSListForm*>(iter) : nullptr);
+	}
+
+	static void OnCycle(const BGSListForm* list) { Log(logLevel) << std::format("JSON warning: form list {:08X} contains itself", list->refID); }
+};
 
-		if (item->typeID == kFormType_TESObjectWEAP)
-			list = reinterpret_cast<TESObjectWEAP*>(item)->repairItemList.listForm;
-		else if (item->typeID == kFormType_TESObjectARMO)
-			list = reinterpret_cast<TESObjectARMO*>(item)->repairItemList.listForm;
-		else continue;
+// form list refID -> refIDs of every non-list form reachable from it, shared by all rules naming the list during a load
+ListFlattener<ListFormTraits> g_ListToForms;
 
-		if (list && list->refID == form->refID) output.push_back(item->refID);
+struct RepairListFormTraits
+{
+	using Form = TESForm;
+
+	static UInt32 GetID(const TESForm* form) { return form->refID; }
+
+	static UInt32 GetRepairListID(const TESForm* form)
+	{
+		BGSListForm* list = nullptr;
+		if (form->typeID == kFormType_TESObjectWEAP) list = reinterpret_cast<const TESObjectWEAP*>(form)->repairItemList.listForm;
+		else if (form->typeID == kFormType_TESObjectARMO) list = reinterpret_cast<const TESObjectARMO*>(form)->repairItemList.listForm;
+		return list ? list->refID : 0;
 	}
-	return output;
+};
+
+// repair list refID -> weapons and armor using it, shared by all rules naming a repair list during a load
+RepairListIndex<RepairListFormTraits> g_RepairListToForms;
+
+std::vector<UInt32> FlattenListRepair(TESForm* form)
+{
+	g_RepairListToForms.Build(*TESForm::GetAll());
+	return g_RepairListToForms.Flatten(form->refID);
 }
 
 Object::Object(const JSON& elem)
@@ -87,7 +136,9 @@ Item::Item(const JSON& elem) : Object(elem)
 		forms = true;
 
 		for (const auto form : GetFormsFromElement(elem["mod"], elem["form"]))
-			formIDs.insert_range(repairList ? FlattenListRepair(form) : FlattenListForm(form));
+			if (repairList) formIDs.insert_range(FlattenListRepair(form));
+			else if (form->typeID == kFormType_BGSListForm) formIDs.insert_range(g_ListToForms.Flatten(reinterpret_cast<BGSListForm*>(form)));
+			else formIDs.emplace(form->refID);
 	}
 }
 
@@ -110,28 +161,35 @@ Weapon::Weapon(const JSON& elem) : Item(elem)
 	if (elem.contains("weaponType"))			type.insert_range(GetSetFromElement<UInt32>(elem["weaponType"]));
 }
 
+const std::unordered_map<std::string_view, UInt32> kArmorSlots
+{
+	{ "armorHead",			1 << 0x0 },
+	{ "armorHair",			1 << 0x1 },
+	{ "armorUpperBody",		1 << 0x2 },
+	{ "armorLeftHand",		1 << 0x3 },
+	{ "armorRightHand",		1 << 0x4 },
+	{ "armorWeapon",		1 << 0x5 },
+	{ "armorPipBoy",		1 << 0x6 },
+	{ "armorBackpack",		1 << 0x7 },
+	{ "armorNecklace",		1 << 0x8 },
+	{ "armorHeadband",		1 << 0x9 },
+	{ "armorHat",			1 << 0xA },
+	{ "armorEyeglasses",	1 << 0xB },
+	{ "armorNosering",		1 << 0xC },
+	{ "armorEarrings",		1 << 0xD },
+	{ "armorMask",			1 << 0xE },
+	{ "armorChoker",		1 << 0xF },
+	{ "armorMouthObject",	1 << 0x10 },
+	{ "armorBodyAddon1",	1 << 0x11 },
+	{ "armorBodyAddon2",	1 << 0x12 },
+	{ "armorBodyAddon3",	1 << 0x13 },
+};
+
 Armor::Armor(const JSON& elem) : Item(elem)
 {
-	if (elem.contains("armorHead")) 			(elem["armorHead"].get<SInt8>() == 1 ?			slotsMaskWL : slotsMaskBL) += 1 << 0x0;
-	if (elem.contains("armorHair")) 			(elem["armorHair"].get<SInt8>() == 1 ?			slotsMaskWL : slotsMaskBL) += 1 << 0x1;
-	if (elem.contains("armorUpperBody")) 		(elem["armorUpperBody"].get<SInt8>() == 1 ?		slotsMaskWL : slotsMaskBL) += 1 << 0x2;
-	if (elem.contains("armorLeftHand"))			(elem["armorLeftHand"].get<SInt8>() == 1 ?		slotsMaskWL : slotsMaskBL) += 1 << 0x3;
-	if (elem.contains("armorRightHand")) 		(elem["armorRightHand"].get<SInt8>() == 1 ?		slotsMaskWL : slotsMaskBL) += 1 << 0x4;
-	if (elem.contains("armorWeapon")) 			(elem["armorWeapon"].get<SInt8>() == 1 ?		slotsMaskWL : slotsMaskBL) += 1 << 0x5;
-	if (elem.contains("armorPipBoy")) 			(elem["armorPipBoy"].get<SInt8>() == 1 ?		slotsMaskWL : slotsMaskBL) += 1 << 0x6;
-	if (elem.contains("armorBackpack"))			(elem["armorBackpack"].get<SInt8>() == 1 ?		slotsMaskWL : slotsMaskBL) += 1 << 0x7;
-	if (elem.contains("armorNecklace"))			(elem["armorNecklace"].get<SInt8>() == 1 ?		slotsMaskWL : slotsMaskBL) += 1 << 0x8;
-	if (elem.contains("armorHeadband"))			(elem["armorHeadband"].get<SInt8>() == 1 ?		slotsMaskWL : slotsMaskBL) += 1 << 0x9;
-	if (elem.contains("armorHat")) 				(elem["armorHat"].get<SInt8>() == 1 ?			slotsMaskWL : slotsMaskBL) += 1 << 0xA;
-	if (elem.contains("armorEyeglasses"))		(elem["armorEyeglasses"].get<SInt8>() == 1 ?	slotsMaskWL : slotsMaskBL) += 1 << 0xB;
-	if (elem.contains("armorNosering"))			(elem["armorNosering"].get<SInt8>() == 1 ?		slotsMaskWL : slotsMaskBL) += 1 << 0xC;
-	if (elem.contains("armorEarrings"))			(elem["armorEarrings"].get<SInt8>() == 1 ?		slotsMaskWL : slotsMaskBL) += 1 << 0xD;
-	if (elem.contains("armorMask")) 			(elem["armorMask"].get<SInt8>() == 1 ?			slotsMaskWL : slotsMaskBL) += 1 << 0xE;
-	if (elem.contains("armorChoker")) 			(elem["armorChoker"].get<SInt8>() == 1 ?		slotsMaskWL : slotsMaskBL) += 1 << 0xF;
-	if (elem.contains("armorMouthObject"))		(elem["armorMouthObject"].get<SInt8>() == 1 ?	slotsMaskWL : slotsMaskBL) += 1 << 0x10;
-	if (elem.contains("armorBodyAddon1"))		(elem["armorBodyAddon1"].get<SInt8>() == 1 ?	slotsMaskWL : slotsMaskBL) += 1 << 0x11;
-	if (elem.contains("armorBodyAddon2"))		(elem["armorBodyAddon2"].get<SInt8>() == 1 ?	slotsMaskWL : slotsMaskBL) += 1 << 0x12;
-	if (elem.contains("armorBodyAddon3"))		(elem["armorBodyAddon3"].get<SInt8>() == 1 ?	slotsMaskWL : slotsMaskBL) += 1 << 0x13;
+	for (const auto& [key, value] : elem.items())
+		if (const auto iter = kArmorSlots.find(key); iter != kArmorSlots.end())
+			(value.get<SInt8>() == 1 ? slotsMaskWL : slotsMaskBL) |= iter->second;
 
 	if (elem.contains("armorClass"))			armorClass = elem["armorClass"].get<UInt16>();
 	if (elem.contains("armorPower"))			powerArmor = elem["armorPower"].get<SInt8>();
@@ -194,96 +252,393 @@ void Files::HandleXML(const std::filesystem::path& path)
 	g_XMLPaths.emplace_back(pathstring.substr(pathstring.find_last_of("\\Data\\") - 3));
 }
 
-void Files::HandleJSON(const std::filesystem::path& path)
+// builds rules as RuleStream hands over the elements of a file, each element is moved into its object and never copied
+// legacy "tags" and "icons" arrays are read like "items" and "categories", a file naming both gets the rules of both
+class RuleBuilder
 {
-	Log(logLevel) << "\nJSON message: reading  " + path.string();
-	try
-	{
-		std::ifstream i(path);
-		auto j = nlohmann::json::parse(i, nullptr, true, true);
+	const std::filesystem::path&	path;
+	const std::string				file;
+	UInt32							itemIndex = 0, iconIndex = 0, tabIndex = 0;
+	bool							items = false, categories = false, tabs = false;
 
-		nlohmann::basic_json items;
+	// file-wide atlas for packs whose icons are packed into one texture, categories can still override it;
+	// it may come after the categories in the file, so it is applied once the whole file is read
+	std::string						texatlas;
+	std::vector<Icon*>				icons;
 
-		if (j.contains("items")) items = j["items"];
-		else if (j.contains("tags")) items = j["tags"]; // legacy
+	void Stamp(Object* object, UInt32& index) const
+	{
+		object->file = file;
+		object->fileIndex = index++;
+	}
 
-		if (!items.is_array()) Log(logLevel) << "JSON message: ySI item array not detected in " + path.string();
-		else for (const auto& elem : items) if (!elem.is_object())
+	static bool Check(const nlohmann::json& elem)
+	{
+		if (!elem.is_object())
 		{
 			Log(logLevel) << "JSON error: Expected object";
-			return;
+			return false;
 		}
-		else if (!elem.contains("tag") || !elem.contains("priority"))
+		if (!elem.contains("tag") || !elem.contains("priority"))
 		{
 			Log(logLevel) << "JSON error: Expected tag and priority";
-			return;
+			return false;
 		}
-		else
+		return true;
+	}
+
+public:
+	RuleBuilder(const std::filesystem::path& path) : path(path), file(path.filename().string()) {}
+
+	void Array(const std::string& key)
+	{
+		if (key == "items" || key == "tags") items = true;
+		else if (key == "categories" || key == "icons") categories = true;
+		else if (key == "tabs") tabs = true;
+	}
+
+	bool Element(const std::string& key, nlohmann::json&& elem)
+	{
+		if (key == "items" || key == "tags")
 		{
-			std::unordered_set<UInt8> formType;
+			if (!Check(elem)) return false;
 
+			std::unordered_set<UInt8> formType;
 			if (elem.contains("formType")) formType.insert_range(GetSetFromElement<UInt8>(elem["formType"]));
 
+			std::string source;
+			if (bHotReload) source = elem.dump();
+
 			std::unique_ptr<Item> item;
-			
-			if (formType.contains(kFormType_TESObjectWEAP))			item = std::make_unique<Weapon>(JSON(elem));
-			else if (formType.contains(kFormType_TESObjectARMO))	item = std::make_unique<Armor>(JSON(elem));
-			else if (formType.contains(kFormType_AlchemyItem))		item = std::make_unique<Aid>(JSON(elem));
-			else													item = std::make_unique<Item>(JSON(elem));
 
+			if (formType.contains(kFormType_TESObjectWEAP))			item = std::make_unique<Weapon>(JSON(std::move(elem)));
+			else if (formType.contains(kFormType_TESObjectARMO))	item = std::make_unique<Armor>(JSON(std::move(elem)));
+			else if (formType.contains(kFormType_AlchemyItem))		item = std::make_unique<Aid>(JSON(std::move(elem)));
+			else													item = std::make_unique<Item>(JSON(std::move(elem)));
+
+			Stamp(item.get(), itemIndex);
+			item->source = std::move(source);
 			if (item->IsValid()) g_Items.emplace_back(std::move(item));
 		}
+		else if (key == "categories" || key == "icons")
+		{
+			if (!Check(elem)) return false;
 
-		nlohmann::basic_json categories;
+			auto category = std::make_unique<Icon>(JSON(std::move(elem)));
+			Stamp(category.get(), iconIndex);
+			if (!category->IsValid()) return true;
+			if (category->texatlas.empty()) icons.emplace_back(category.get());
+			g_Icons.emplace_back(std::move(category));
+		}
+		else if (key == "tabs")
+		{
+			if (!Check(elem)) return false;
+
+			std::unique_ptr<Category> tab;
 
-		if (j.contains("categories")) categories = j["categories"];
-		else if (j.contains("icons")) categories = j["icons"]; // legacy
+			if (elem.contains("keyring"))							tab = std::make_unique<Keyring>(JSON(std::move(elem)));
+			else													tab = std::make_unique<Tab>(JSON(std::move(elem)));
 
-		if (!categories.is_array()) Log(logLevel) << "JSON message: ySI category array not detected in " + path.string();
-		else for (const auto& elem : categories) if (!elem.is_object())
+			Stamp(tab.get(), tabIndex);
+			if (tab->IsValid()) g_Categories.emplace_back(std::move(tab));
+		}
+		// written by the atlas packer, categories using a packed icon pick up its atlas once all files are read
+		else if (key == "atlas")
 		{
-			Log(logLevel) << "JSON error: Expected object";
-			return;
+			if (elem.is_object() && elem.contains("filename") && elem.contains("texatlas"))
+				g_IconToAtlas[ToLower(elem["filename"].get<std::string>())] = elem["texatlas"].get<std::string>();
 		}
-		else if (!elem.contains("tag") || !elem.contains("priority"))
+		return true;
+	}
+
+	void Value(const std::string& key, nlohmann::json&& value)
+	{
+		if (key == "texatlas") texatlas = value.get<std::string>();
+	}
+
+	void Finish() const
+	{
+		if (!texatlas.empty()) for (const auto icon : icons) icon->texatlas = texatlas;
+
+		if (!items) Log(logLevel) << "JSON message: ySI item array not detected in " + path.string();
+		if (!categories) Log(logLevel) << "JSON message: ySI category array not detected in " + path.string();
+		if (!tabs) Log(logLevel) << "JSON message: ySI tabs array not detected in " + path.string();
+	}
+};
+
+// data is the file as MessagePack, either just converted from its text or taken from the cache
+bool ApplyJSON(const std::filesystem::path& path, const std::vector<UInt8>& data)
+{
+	Log(logLevel) << "\nJSON message: reading  " + path.string();
+
+	RuleBuilder builder(path);
+	RuleStream stream(builder);
+	try
+	{
+		if (!nlohmann::json::sax_parse(data, &stream, nlohmann::json::input_format_t::msgpack))
 		{
-			Log(logLevel) << "JSON error: Expected tag and priority";
-			return;
+			if (!stream.error.empty()) Log(logLevel) << std::format("JSON error: {}", stream.error);
+			return false;
 		}
-		else
+	}
+	catch (nlohmann::json::exception& e)
+	{
+		Log(logLevel) << "JSON error: JSON file is incorrectly formatted! It will not be applied. " + path.string();
+		Log(logLevel) << std::format("JSON error: {}", e.what());
+		return false;
+	}
+	builder.Finish();
+	return true;
+}
+
+
+// rule files kept as MessagePack between launches, a file's text is only parsed again once its size or write time changes
+// this saves the text parse, not the load: the bytes are still decoded and every rule is built again on each launch,
+// since rules hold forms resolved against the current load order
+namespace Cache
+{
+	constexpr UInt32 kMagic		= 'ySIC';
+	constexpr UInt32 kVersion	= 1;
+
+	struct Entry
+	{
+		UInt64					size = 0;
+		SInt64					time = 0;
+		std::vector<UInt8>		data;
+
+		bool Matches(const Entry& stamp) const { return size == stamp.size && time == stamp.time; }
+	};
+
+	std::filesystem::path GetPath() { return GetCurPath() / R"(Data\NVSE\Plugins\ySI.cache)"; }
+
+	Entry GetStamp(const std::filesystem::path& path)
+	{
+		std::error_code error;
+		Entry stamp;
+		stamp.size = std::filesystem::file_size(path, error);
+		stamp.time = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+		return stamp;
+	}
+
+	std::unordered_map<std::string, Entry> Read()
+	{
+		std::unordered_map<std::string, Entry> entries;
+
+		std::ifstream file(GetPath(), std::ios::binary);
+		if (!file) return entries;
+		const std::vector<UInt8> buffer{ std::istreambuf_iterator(file), std::istreambuf_iterator<char>() };
+
+		UInt32 offset = 0;
+		const auto read = [&]<typename T>(T& value)
 		{
-			auto category = std::make_unique<Icon>(JSON(elem));
-			if (category->IsValid()) g_Icons.emplace_back(std::move(category));
+			if (offset + sizeof(T) > buffer.size()) return false;
+			memcpy(&value, buffer.data() + offset, sizeof(T));
+			offset += sizeof(T);
+			return true;
+		};
+
+		UInt32 magic = 0, version = 0, count = 0;
+		if (!read(magic) || magic != kMagic || !read(version) || version != kVersion || !read(count)) return entries;
+
+		for (UInt32 i = 0; i < count; i++)
+		{
+			UInt32 nameLength = 0, dataLength = 0;
+			Entry entry;
+			if (!read(nameLength) || offset + nameLength > buffer.size()) return {};
+			std::string name(reinterpret_cast<const char*>(buffer.data() + offset), nameLength);
+			offset += nameLength;
+			if (!read(entry.size) || !read(entry.time) || !read(dataLength) || offset + dataLength > buffer.size()) return {};
+			entry.data.assign(buffer.begin() + offset, buffer.begin() + offset + dataLength);
+			offset += dataLength;
+			entries.emplace(std::move(name), std::move(entry));
 		}
 
-		nlohmann::basic_json tabs;
+		return entries;
+	}
 
-		if (j.contains("tabs")) tabs = j["tabs"];
+	void Write(const std::vector<std::pair<std::string, const Entry*>>& entries)
+	{
+		const auto path = GetPath();
+		auto temp = path;
+		temp += ".tmp";
 
-		if (!tabs.is_array()) Log(logLevel) << "JSON message: ySI tabs array not detected in " + path.string();
-		else for (const auto& elem : tabs) if (!elem.is_object())
 		{
-			Log(logLevel) << "JSON error: Expected object";
-			return;
+			std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+			if (!file) return;
+
+			const auto write = [&]<typename T>(const T& value) { file.write(reinterpret_cast<const char*>(&value), sizeof(T)); };
+
+			write(kMagic);
+			write(kVersion);
+			write(static_cast<UInt32>(entries.size()));
+			for (const auto& [name, entry] : entries)
+			{
+				write(static_cast<UInt32>(name.size()));
+				file.write(name.data(), name.size());
+				write(entry->size);
+				write(entry->time);
+				write(static_cast<UInt32>(entry->data.size()));
+				file.write(reinterpret_cast<const char*>(entry->data.data()), entry->data.size());
+			}
+			if (!file) return;
 		}
-		else if (!elem.contains("tag") || !elem.contains("priority"))
+
+		std::error_code error;
+		std::filesystem::rename(temp, path, error);
+		if (error) Log(logLevel) << "JSON message: failed to write rule cache " + path.string();
+	}
+}
+
+// a file as MessagePack, ready to be streamed into rules; the same bytes are written back to the cache
+struct ParsedJSON
+{
+	std::string					error;
+	Cache::Entry				cache;
+	bool						cached = false;
+	std::chrono::microseconds	readTime{};
+	std::chrono::microseconds	parseTime{};
+};
+
+// text goes straight to MessagePack without a document in between, a cache hit is only checked to be well formed and
+// takes over the entry's bytes instead of copying them
+ParsedJSON ParseJSON(const std::filesystem::path& path, Cache::Entry* cached)
+{
+	ParsedJSON parsed;
+	parsed.cache = Cache::GetStamp(path);
+
+	const auto start = std::chrono::steady_clock::now();
+	if (cached && cached->Matches(parsed.cache))
+	{
+		nlohmann::detail::json_sax_acceptor<nlohmann::json> acceptor;
+		if (nlohmann::json::sax_parse(cached->data, &acceptor, nlohmann::json::input_format_t::msgpack))
 		{
-			Log(logLevel) << "JSON error: Expected tag and priority";
-			return;
+			parsed.cache.data = std::move(cached->data);
+			parsed.cached = true;
+			parsed.parseTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+			return parsed;
+		}
+	}
+
+	std::ifstream i(path, std::ios::binary);
+	const std::string buffer{ std::istreambuf_iterator(i), std::istreambuf_iterator<char>() };
+	const auto read = std::chrono::steady_clock::now();
+	parsed.readTime = std::chrono::duration_cast<std::chrono::microseconds>(read - start);
+
+	MsgPackWriter writer(parsed.cache.data);
+	if (!nlohmann::json::sax_parse(buffer, &writer, nlohmann::json::input_format_t::json, true, true))
+	{
+		parsed.error = writer.error;
+		parsed.cache.data.clear();
+	}
+	parsed.parseTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - read);
+	return parsed;
+}
+
+void Files::HandleJSON(std::vector<std::filesystem::path> paths)
+{
+	// rule priority ties are resolved by load order, so files are always handled in file name order
+	ra::sort(paths, [](const std::filesystem::path& path1, const std::filesystem::path& path2) { return path1.filename() < path2.filename(); });
+
+	auto cache = Cache::Read();
+	const auto cacheSize = cache.size();
+
+	// reading and parsing touch no game data and run on a small pool, building rules stays on this thread
+	// workers stay at most a few files ahead of the file being handled, and no file is ever held as a whole document
+	std::vector<ParsedJSON> parsed(paths.size());
+	std::vector<UInt8> ready(paths.size());
+	std::mutex mutex;
+	std::condition_variable notify;
+	UInt32 next = 0, handled = 0;
+
+	const UInt32 threadCount = std::min<UInt32>(paths.size(), std::clamp(std::thread::hardware_concurrency(), 1u, 4u));
+	const UInt32 window = threadCount * 2;
+
+	const auto worker = [&]
+	{
+		while (true)
+		{
+			UInt32 i;
+			Cache::Entry* cached = nullptr;
+			{
+				std::unique_lock lock(mutex);
+				notify.wait(lock, [&] { return next >= paths.size() || next < handled + window; });
+				if (next >= paths.size()) return;
+				i = next++;
+				if (const auto iter = cache.find(paths[i].filename().string()); iter != cache.end()) cached = &iter->second;
+			}
+			auto result = ParseJSON(paths[i], cached);
+			{
+				std::scoped_lock lock(mutex);
+				parsed[i] = std::move(result);
+				ready[i] = true;
+			}
+			notify.notify_all();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (UInt32 i = 0; i < threadCount; i++) threads.emplace_back(worker);
+
+	for (UInt32 i = 0; i < paths.size(); i++)
+	{
+		{
+			std::unique_lock lock(mutex);
+			notify.wait(lock, [&] { return ready[i] != 0; });
+		}
+
+		const auto& path = paths[i];
+		if (!parsed[i].error.empty())
+		{
+			Log(logLevel) << "JSON error: JSON file is incorrectly formatted! It will not be applied. " + path.string();
+			Log(logLevel) << std::format("JSON error: {}", parsed[i].error);
 		}
 		else
 		{
-			std::unique_ptr<Category> tab;
+			const auto then = std::chrono::steady_clock::now();
+			ApplyJSON(path, parsed[i].cache.data);
+			const auto handleTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - then);
 
-			if (elem.contains("keyring"))							tab = std::make_unique<Keyring>(JSON(elem));
-			else													tab = std::make_unique<Tab>(JSON(elem));
+			Log(logLevel) << std::format("JSON message: {} read in {:d} us, {} in {:d} us, handled in {:d} us", path.filename().string(),
+				parsed[i].readTime.count(), parsed[i].cached ? "loaded from cache" : "parsed", parsed[i].parseTime.count(), handleTime.count());
+		}
 
-			if (tab->IsValid()) g_Categories.emplace_back(std::move(tab));
+		{
+			std::scoped_lock lock(mutex);
+			handled = i + 1;
 		}
+		notify.notify_all();
 	}
-	catch (nlohmann::json::exception& e)
+
+	for (auto& thread : threads) thread.join();
+
+	// rewrite the cache only when a file was added, changed or removed
+	std::vector<std::pair<std::string, const Cache::Entry*>> entries;
+	bool changed = false;
+	for (UInt32 i = 0; i < paths.size(); i++)
 	{
-		Log(logLevel) << "JSON error: JSON file is incorrectly formatted! It will not be applied. " + path.string();
-		Log(logLevel) << std::format("JSON error: {}", e.what());
+		if (!parsed[i].error.empty()) continue;
+		entries.emplace_back(paths[i].filename().string(), &parsed[i].cache);
+		changed |= !parsed[i].cached;
 	}
+	if (changed || entries.size() != cacheSize) Cache::Write(entries);
+
+	g_RepairListToForms.Clear();
+	g_ListToForms.Clear();
 }
+
+bool Files::HandleJSON(const std::filesystem::path& path)
+{
+	const auto parsed = ParseJSON(path, nullptr);
+	if (!parsed.error.empty())
+	{
+		Log(logLevel) << "JSON error: JSON file is incorrectly formatted! It will not be applied. " + path.string();
+		Log(logLevel) << std::format("JSON error: {}", parsed.error);
+		return false;
+	}
+	const auto applied = ApplyJSON(path, parsed.cache.data);
+
+	g_RepairListToForms.Clear();
+	g_ListToForms.Clear();
+
+	return applied;
+}
\ No newline at end of file
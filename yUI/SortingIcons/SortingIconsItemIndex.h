@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace SortingIcons
+{
+	// rules bucketed by explicit formID and by formType, each bucket kept in priority order, so a lookup only evaluates
+	// the rules a form can match; Rule supplies index, formIDs and formType, the game rules are Item, tests use a mock
+	template <typename Rule> class ItemIndex
+	{
+		std::unordered_map<UInt32, std::vector<Rule*>>	byID;
+		std::array<std::vector<Rule*>, 0x100>			byType;
+
+	public:
+		// numbers the rules in the order given, which has to be the order they are evaluated in
+		template <typename Rules> void Build(const Rules& rules)
+		{
+			byID.clear();
+			for (auto& bucket : byType) bucket.clear();
+
+			UInt32 index = 0;
+			for (const auto& entry : rules)
+			{
+				const auto rule = std::to_address(entry);
+				rule->index = index++;
+
+				// a rule with formIDs can only match those forms, regardless of its formType
+				if (!rule->formIDs.empty())
+					for (const auto refID : rule->formIDs) byID[refID].emplace_back(rule);
+				else if (!rule->formType.empty())
+					for (const auto type : rule->formType) byType[type].emplace_back(rule);
+				else
+					for (auto& bucket : byType) bucket.emplace_back(rule);
+			}
+		}
+
+		// the first rule by index that satisfies the form, each candidate is evaluated at most once
+		template <typename Satisfies> Rule* Find(const UInt32 refID, const UInt8 typeID, Satisfies&& satisfies) const
+		{
+			const auto& typed = byType[typeID];
+			auto typeIter = typed.begin();
+
+			// merge both candidate buckets by index so the first satisfied rule is the same one a linear scan would find
+			if (const auto named = byID.find(refID); named != byID.end())
+				for (const auto rule : named->second)
+				{
+					for (; typeIter != typed.end() && (*typeIter)->index < rule->index; ++typeIter)
+						if (satisfies(*typeIter)) return *typeIter;
+					if (satisfies(rule)) return rule;
+				}
+
+			for (; typeIter != typed.end(); ++typeIter)
+				if (satisfies(*typeIter)) return *typeIter;
+
+			return nullptr;
+		}
+	};
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace SortingIcons::Files
+{
+	// flattens nested form lists into the IDs of their members, lists are only walked once and cycles are broken
+	// Traits supplies the list type, GetID(list), ForEach(list, visit) calling visit(id, nested list or nullptr) and
+	// OnCycle(list) for a list found to contain itself; the game traits live with the JSON loader, tests use a mock graph
+	template <typename Traits> class ListFlattener
+	{
+		using List = typename Traits::List;
+
+		std::unordered_map<UInt32, std::vector<UInt32>>		flattened;
+		std::unordered_map<UInt32, UInt32>					path;		// lists being walked, to their depth
+
+		// appends the list's members, lists already on the path are skipped to break cycles; returns the shallowest depth a
+		// skip pointed at, a list whose members skipped one above it is missing the rest of that cycle and is not cached
+		UInt32 Append(List* list, std::vector<UInt32>& output)
+		{
+			const auto id = Traits::GetID(list);
+			if (const auto iter = flattened.find(id); iter != flattened.end())
+			{
+				output.insert(output.end(), iter->second.begin(), iter->second.end());
+				return UINT32_MAX;
+			}
+
+			const auto [onPath, inserted] = path.try_emplace(id, path.size());
+			const auto own = onPath->second;
+			if (!inserted)
+			{
+				Traits::OnCycle(list);
+				return own;
+			}
+
+			std::vector<UInt32> forms;
+			UInt32 skipped = UINT32_MAX;
+			Traits::ForEach(list, [&](const UInt32 member, List* nested)
+			{
+				if (!nested) forms.push_back(member);
+				else skipped = std::min(skipped, Append(nested, forms));
+			});
+
+			path.erase(id);
+			output.insert(output.end(), forms.begin(), forms.end());
+
+			if (skipped < own) return skipped;
+			flattened.emplace(id, std::move(forms));
+			return UINT32_MAX;
+		}
+
+	public:
+		const std::vector<UInt32>& Flatten(List* list)
+		{
+			std::vector<UInt32> output;
+			Append(list, output);
+			return flattened.at(Traits::GetID(list));
+		}
+
+		bool IsFlattened(const UInt32 id) const { return flattened.contains(id); }
+
+		void Clear() { flattened.clear(); }
+	};
+
+	// forms by the repair list they use, filled by a single pass over every form on first use
+	// Traits supplies the form type, GetID(form) and GetRepairListID(form), 0 for forms without a repair list
+	template <typename Traits> class RepairListIndex
+	{
+		using Form = typename Traits::Form;
+
+		std::unordered_map<UInt32, std::vector<UInt32>>		users;
+		bool												built = false;	// a load order using no repair lists is built too
+
+	public:
+		template <typename Forms> void Build(const Forms& forms)
+		{
+			if (built) return;
+			built = true;
+			for (const Form* form : forms)
+				if (const auto list = Traits::GetRepairListID(form)) users[list].push_back(Traits::GetID(form));
+		}
+
+		// the list's ID followed by every form using it
+		std::vector<UInt32> Flatten(const UInt32 list) const
+		{
+			std::vector<UInt32> output;
+			output.push_back(list);
+			if (const auto iter = users.find(list); iter != users.end()) output.insert(output.end(), iter->second.begin(), iter->second.end());
+			return output;
+		}
+
+		bool IsBuilt() const { return built; }
+
+		void Clear()
+		{
+			users.clear();
+			built = false;
+		}
+	};
+}
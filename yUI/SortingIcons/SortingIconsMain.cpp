@@ -3,6 +3,7 @@
 #include <main.h>
 #include <functions.h>
 #include <SimpleINILibrary.h>
+#include <GameData.h>
 
 namespace SortingIcons
 {
@@ -24,16 +25,55 @@ namespace SortingIcons
 		bIcons = ini.GetOrCreate("Sorting and Icons", "bAddIconsToInventory", 1, "; add ycons to inventory, container and barter menus");
 		bPrompt = ini.GetOrCreate("Sorting and Icons", "bAddIconsToPrompt", 1, "; add ycons to interaction prompt");
 		bHotkeys = ini.GetOrCreate("Sorting and Icons", "bReplaceHotkeyIcons", 1, "; replace hotkey icons with ycons");
+		bHotReload = ini.GetOrCreate("Sorting and Icons", "bHotReload", 0, "; watch Data\\menus\\ySI and apply changed item and icon rules while the game runs, useful for developers");
+		bReorderRules = ini.GetOrCreate("Sorting and Icons", "bReorderRules", 0, "; after each load, evaluate rules of equal priority that match most often first, where that cannot change which tag an item gets");
+		bPruneRules = ini.GetOrCreate("Sorting and Icons", "bPruneRules", 0, "; drop item rules that can never match because an earlier rule matches everything they do, not done with bHotReload");
+		bAnalyzeRules = ini.GetOrCreate("Sorting and Icons", "bAnalyzeRules", 0, "; log shadowed, dead and redundant item rules after loading, checked against every loaded inventory form");
+		iCacheSize = ini.GetOrCreate("Sorting and Icons", "iCacheSize", 8192, "; how many item forms remember their sorting tag, older entries are replaced once it is full");
+		bBenchmark = ini.GetOrCreate("Sorting and Icons", "bBenchmark", 0, "; time item matching over every loaded inventory form after loading and compare it with a plain rule scan, results go to the log");
 
 		ini.SaveFile(iniPath.c_str(), false);
 	}
 
-	void ProcessEntries()
+	// gives every tag a dense ID in alphabetical order, so lookups index tables and sorting compares integers instead of strings
+	std::unordered_map<std::string, UInt32> InternTags()
+	{
+		std::vector<Object*> objects;
+		for (const auto& entry : g_Items) objects.emplace_back(entry.get());
+		for (const auto& entry : g_Icons) objects.emplace_back(entry.get());
+		for (const auto& entry : g_Categories) objects.emplace_back(entry.get());
+
+		ra::sort(objects, [&](const Object* entry1, const Object* entry2) { return entry1->tag < entry2->tag; });
+
+		std::unordered_map<std::string, UInt32> tagIDs;
+		for (const auto object : objects)
+			object->tagID = tagIDs.emplace(object->tag, tagIDs.size()).first->second;
+		return tagIDs;
+	}
+
+	// equal priorities are ordered by file name and position in file, so the order is the same after a hot reload
+	template <typename T> void SortByPriority(std::vector<std::unique_ptr<T>>& entries)
 	{
-		ra::sort(g_Items, [&](const std::unique_ptr<Item>& entry1, const std::unique_ptr<Item>& entry2) { return entry1->priority > entry2->priority; });
-		ra::sort(g_Icons, [&](const std::unique_ptr<Icon>& entry1, const std::unique_ptr<Icon>& entry2) { return entry1->priority > entry2->priority; });
-		ra::sort(g_Categories, [&](const std::unique_ptr<Category>& entry1, const std::unique_ptr<Category>& entry2) { return entry1->priority > entry2->priority; });
+		ra::sort(entries, [&](const std::unique_ptr<T>& entry1, const std::unique_ptr<T>& entry2)
+		{
+			if (entry1->priority != entry2->priority) return entry1->priority > entry2->priority;
+			if (entry1->file != entry2->file) return entry1->file < entry2->file;
+			return entry1->fileIndex < entry2->fileIndex;
+		});
+	}
+
+	void IndexEntries()
+	{
+		SortByPriority(g_Items);
+		SortByPriority(g_Icons);
+
+		Item::BuildIndex();
+		const auto tagIDs = InternTags();
 
+		g_TagToIcon.assign(tagIDs.size(), nullptr);
+		g_TagToTab.assign(tagIDs.size(), nullptr);
+
+		categoryDefault = nullptr;
 		for (const auto& entry : g_Icons) {
 //			if (!entry->name.empty()) g_Keyrings.emplace_back(entry);
 			if (entry->tag.empty())
@@ -41,17 +81,234 @@ namespace SortingIcons
 				categoryDefault = entry.get();
 				Log(logLevel) << "ySI: Default category is '" + entry->filename + "'";
 			}
-//			Set(entry->tag, entry);
+			if (entry->texatlas.empty() && !entry->filename.empty())
+				if (const auto iter = g_IconToAtlas.find(ToLower(std::string(entry->filename))); iter != g_IconToAtlas.end()) entry->texatlas = iter->second;
+			g_TagToIcon[entry->tagID] = entry.get();
 		}
 
+		for (const auto& entry : g_Categories)
+		{
+			if (!g_TagToTab[entry->tagID]) g_TagToTab[entry->tagID] = (Tab*) entry.get();
+			entry->InternTags(tagIDs);
+		}
+
+		Keyrings::BuildMasks();
+		Tabs::BuildMasks();
+	}
+
+	void ProcessEntries()
+	{
+		SortByPriority(g_Categories);
+
 		for (const auto& entry : g_Categories)
 		{
 			if (entry->IsKey()) g_Keyrings.emplace_back((Keyring*)entry.get());
 			if (entry->IsInventory()) g_Tabline.emplace_back((Tab*)entry.get());
-			g_StringToTabs.emplace(entry->tag, (Tab*) entry.get());
 		}
 
 		ra::sort(g_Tabline, [&](const Tab* entry1, const Tab* entry2) { return entry1->tabPriority > entry2->tabPriority; });
+
+		IndexEntries();
+	}
+
+	// an item rule is shadowed when an earlier rule covers it, evaluating it can then only ever cost time
+	std::unordered_map<const Item*, const Item*> FindShadowed()
+	{
+		std::unordered_map<const Item*, const Item*> shadowed;
+		for (UInt32 i = 1; i < g_Items.size(); i++)
+			for (UInt32 j = 0; j < i; j++)
+				if (g_Items[j]->Covers(g_Items[i].get()))
+				{
+					shadowed.emplace(g_Items[i].get(), g_Items[j].get());
+					break;
+				}
+		return shadowed;
+	}
+
+	void AnalyzeRules()
+	{
+		// the pairwise check is quadratic in the rule count, skip it when nothing would use the result
+		if (!bAnalyzeRules && (!bPruneRules || bHotReload)) return;
+
+		const auto shadowed = FindShadowed();
+
+		if (bAnalyzeRules)
+		{
+			for (const auto& [item, by] : shadowed)
+				Log(logLevel) << std::format("ySI analysis: rule '{}' ({}:{:d}) is shadowed by '{}' ({}:{:d})",
+					item->tag, item->file, item->fileIndex, by->tag, by->file, by->fileIndex);
+
+			for (const auto& item : g_Items)
+				if (const auto issue = item->CheckConditions(); !issue.empty())
+					Log(logLevel) << std::format("ySI analysis: rule '{}' ({}:{:d}): {}", item->tag, item->file, item->fileIndex, issue);
+
+			// rules no static check catches can still be dead or shadowed for the forms this load order has
+			std::unordered_map<const Item*, UInt32> satisfied, won;
+			for (const auto form : *TESForm::GetAll())
+			{
+				if (!form->IsInventoryObjectAlt()) continue;
+				for (const auto& item : g_Items) if (item->Satisfies(form)) satisfied[item.get()]++;
+				if (const auto item = Item::Get(form)) won[item]++;
+			}
+			Item::ClearCache();
+			Item::ResetStats();
+
+			for (const auto& item : g_Items)
+			{
+				if (shadowed.contains(item.get())) continue;
+				if (!satisfied.contains(item.get()))
+					Log(logLevel) << std::format("ySI analysis: rule '{}' ({}:{:d}) matches no loaded form", item->tag, item->file, item->fileIndex);
+				else if (!won.contains(item.get()))
+					Log(logLevel) << std::format("ySI analysis: rule '{}' ({}:{:d}) matches {:d} loaded forms but always loses to an earlier rule",
+						item->tag, item->file, item->fileIndex, satisfied.at(item.get()));
+			}
+		}
+
+		// a rule could stop being shadowed once its shadowing rule is edited, so nothing is dropped while hot reloading
+		if (!bPruneRules || bHotReload || shadowed.empty()) return;
+
+		std::erase_if(g_Items, [&](const std::unique_ptr<Item>& item) { return shadowed.contains(item.get()); });
+		Item::BuildIndex();
+		Log(logLevel) << std::format("ySI: pruned {:d} shadowed item rules, {:d} left", shadowed.size(), g_Items.size());
+	}
+
+	namespace HotReload
+	{
+		std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes;
+
+		std::unordered_map<std::string, std::filesystem::file_time_type> GetWriteTimes(const std::filesystem::path& dir)
+		{
+			std::unordered_map<std::string, std::filesystem::file_time_type> times;
+			std::error_code error;
+			for (const auto& iter : std::filesystem::directory_iterator(dir, error))
+				if (iter.path().extension().string() == ".json") times.emplace(iter.path().filename().string(), iter.last_write_time(error));
+			return times;
+		}
+
+		// only looks at the first count entries, the ones loaded before the file was read again
+		template <typename T> std::vector<std::unique_ptr<T>> TakeFromFile(std::vector<std::unique_ptr<T>>& entries, const std::string& file, UInt32 count)
+		{
+			std::vector<std::unique_ptr<T>> taken;
+			for (UInt32 i = 0; i < count; i++) if (entries[i]->file == file) taken.emplace_back(std::move(entries[i]));
+			std::erase(entries, nullptr);
+			return taken;
+		}
+
+		// rules identical to one loaded before keep the old object, so cached matches pointing at it stay valid
+		std::vector<Item*> ReuseUnchanged(UInt32 first, std::vector<std::unique_ptr<Item>>& previous)
+		{
+			std::unordered_multimap<std::string, std::unique_ptr<Item>*> bySource;
+			for (auto& entry : previous) bySource.emplace(entry->source, &entry);
+
+			std::vector<Item*> added;
+			for (auto i = first; i < g_Items.size(); i++)
+			{
+				const auto iter = bySource.find(g_Items[i]->source);
+				if (iter == bySource.end())
+				{
+					added.emplace_back(g_Items[i].get());
+					continue;
+				}
+				auto& reused = *iter->second;
+				bySource.erase(iter);
+				reused->fileIndex = g_Items[i]->fileIndex;
+				g_Items[i] = std::move(reused);
+			}
+			std::erase(previous, nullptr);
+			return added;
+		}
+
+		void Reload(const std::filesystem::path& path)
+		{
+			const auto then = std::chrono::steady_clock::now();
+			const auto file = path.filename().string();
+
+			const UInt32 itemCount = g_Items.size();
+			const UInt32 iconCount = g_Icons.size();
+			const UInt32 categoryCount = g_Categories.size();
+
+			// a file saved mid-edit usually doesn't parse, its previous rules stay until it does
+			if (std::filesystem::exists(path) && !Files::HandleJSON(path))
+			{
+				g_Items.resize(itemCount);
+				g_Icons.resize(iconCount);
+				g_Categories.resize(categoryCount);
+				Log(logLevel) << std::format("ySI: kept the previous rules of {}", file);
+				return;
+			}
+
+			auto previousItems = TakeFromFile(g_Items, file, itemCount);
+			auto previousIcons = TakeFromFile(g_Icons, file, iconCount);
+
+			// tabs and keyrings are already built into the menus, changing those still needs a restart
+			if (g_Categories.size() != categoryCount)
+			{
+				g_Categories.resize(categoryCount);
+				Log(logLevel) << "ySI: tabs and keyrings are not hot reloaded, restart the game to apply them";
+			}
+
+			const auto added = ReuseUnchanged(itemCount - previousItems.size(), previousItems);
+
+			IndexEntries();
+
+			std::unordered_set<const Item*> removed;
+			for (const auto& item : previousItems) removed.emplace(item.get());
+			const auto evicted = Item::Invalidate(removed, file, added);
+
+			const auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - then);
+			Log(logLevel) << std::format("ySI: reloaded {} in {:d} ms, {:d} rules added, {:d} removed, {:d} cached forms evicted",
+				file, diff.count(), added.size(), removed.size(), evicted);
+		}
+
+		void Update()
+		{
+			static UInt32 lastCheck = 0;
+			if (GetTickCount() - lastCheck < 1000) return;
+			lastCheck = GetTickCount();
+
+			const auto dir = GetCurPath() / R"(Data\menus\ySI)";
+			auto times = GetWriteTimes(dir);
+
+			for (const auto& [file, time] : times)
+				if (const auto iter = writeTimes.find(file); iter == writeTimes.end() || iter->second != time) Reload(dir / file);
+			for (const auto& file : writeTimes | std::views::keys)
+				if (!times.contains(file)) Reload(dir / file);
+
+			writeTimes = std::move(times);
+		}
+	}
+
+	void Benchmark()
+	{
+		std::vector<TESForm*> forms;
+		for (const auto form : *TESForm::GetAll()) if (form->IsInventoryObjectAlt()) forms.emplace_back(form);
+
+		const auto then = std::chrono::steady_clock::now();
+		for (const auto form : forms) Item::Get(form);
+		const auto indexed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - then);
+
+		// the scan is timed as a whole, timing each form on its own rounds most of them down to nothing
+		std::vector<Item*> expected(forms.size());
+		const auto scan = std::chrono::steady_clock::now();
+		for (UInt32 i = 0; i < forms.size(); i++)
+			for (const auto& item : g_Items) if (item->Satisfies(forms[i])) { expected[i] = item.get(); break; }
+		const auto linear = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - scan);
+
+		UInt32 mismatches = 0;
+		for (UInt32 i = 0; i < forms.size(); i++)
+		{
+			const auto matched = Item::Get(forms[i]);
+			if (matched == expected[i]) continue;
+			mismatches++;
+			Log(logLevel) << std::format("ySI benchmark: {:08X} matched '{}', rule scan matched '{}'", forms[i]->refID,
+				matched ? matched->tag : "", expected[i] ? expected[i]->tag : "");
+		}
+
+		Log(logLevel) << std::format("ySI benchmark: {:d} forms, {:d} rules, indexed match {:d} us, rule scan {:d} us, {:d} mismatches",
+			forms.size(), g_Items.size(), indexed.count(), linear.count(), mismatches);
+
+		Item::ClearCache();
+		Item::ResetStats();
 	}
 
 	void DeferredInit()
@@ -59,15 +316,21 @@ namespace SortingIcons
 		Log(logLevel) << "Loading files for Sorting Icons";
 		const auto dir = GetCurPath() / R"(Data\menus\ySI)";
 		const auto then = std::chrono::system_clock::now();
+		std::vector<std::filesystem::path> jsonPaths;
 		if (!std::filesystem::exists(dir)) Log() << dir << " does not exist.";
 		else for (const auto& iter : std::filesystem::directory_iterator(dir))
 			if (iter.is_directory()) Log(logLevel) << iter.path().string() + " found";
-			else if (iter.path().extension().string() == ".json") Files::HandleJSON(iter.path());
+			else if (iter.path().extension().string() == ".json") jsonPaths.emplace_back(iter.path());
 			else if (iter.path().extension().string() == ".xml") Files::HandleXML(iter.path());
+		Files::HandleJSON(std::move(jsonPaths));
 		ProcessEntries();
+		AnalyzeRules();
+		if (bHotReload) HotReload::writeTimes = HotReload::GetWriteTimes(dir);
 		const auto now = std::chrono::system_clock::now();
 		const auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(now - then);
 		Log(logLevel) << std::format("Loaded items, categories and tabs in {:d} ms", diff.count());
+
+		if (bBenchmark) Benchmark();
 	}
 
 	extern void Init()
@@ -85,7 +348,15 @@ namespace SortingIcons
 
 		deferredInit.emplace_back(CraftingComponents::Fill);
 		if (bSort || bIcons || bHotkeys || bCategories) deferredInit.emplace_back(DeferredInit);
+		if (bHotReload) mainLoop.emplace_back(HotReload::Update);
+#if SI_RULE_STATS
+		postLoadGame.emplace_back(Item::DumpStats);
+#endif
+		if (bReorderRules) postLoadGame.emplace_back(Item::Reorder);
+		postLoadGame.emplace_back(Item::ClearCache);
+		postLoadGame.emplace_back(Item::ResetStats);
 //		if (bCategories) mainLoop.emplace_back(Keyrings::KeyringRefreshPostStewie);
 		if (bIcons) mainLoopDoOnce.emplace_back(Icons::InjectTemplates);
+		if (enable && bPrompt) postLoadGame.emplace_back(TextDimensions::Flush);
 	}
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "SortingIcons.h"
+#include "SortingIconsItemIndex.h"
+#include "SortingIconsRadix.h"
 
 #include <Setting.h>
 #include <Tile.h>
@@ -7,6 +9,8 @@
 
 #include <Safewrite.hpp>
 
+#include <array>
+
 namespace SortingIcons
 {
 
@@ -34,7 +38,6 @@ namespace SortingIcons
 		if (!handgrip.empty() && !handgrip.contains(weapon->HandGrip())) return false;
 		if (!attackAnim.empty() && !attackAnim.contains(weapon->AttackAnimation())) return false;
 		if (!reloadAnim.empty() && !reloadAnim.contains(weapon->reloadAnim)) return false;
-		if (!type.empty() && !type.contains(weapon->eWeaponType)) return false;
 
 		if (isAutomatic.has_value() && isAutomatic.value() != weapon->IsAutomatic()) return false;
 		if (hasScope.has_value() && hasScope.value() != weapon->HasScopeAlt()) return false;
@@ -54,6 +57,14 @@ namespace SortingIcons
 		return true;
 	}
 
+	bool Weapon::Narrows() const
+	{
+		return !skill.empty() || !type.empty() || !handgrip.empty() || !attackAnim.empty() || !reloadAnim.empty()
+			|| isAutomatic.has_value() || hasScope.has_value() || ignoresDTDR.has_value()
+			|| clipRoundsMin.has_value() || clipRoundsMax.has_value() || numProjectilesMin.has_value() || numProjectilesMax.has_value()
+			|| !soundLevel.empty() || !ammoIDs.empty();
+	}
+
 	bool Armor::Satisfies(TESForm* form) const
 	{
 		if (!Item::Satisfies(form)) return false;
@@ -74,6 +85,11 @@ namespace SortingIcons
 		return true;
 	}
 
+	bool Armor::Narrows() const
+	{
+		return slotsMaskWL || slotsMaskBL || armorClass || powerArmor || hasBackpack || dt || dr;
+	}
+
 	bool Aid::Satisfies(TESForm* form) const
 	{
 		if (!Item::Satisfies(form)) return false;
@@ -92,6 +108,74 @@ namespace SortingIcons
 		return true;
 	}
 
+	// true when every form the other rule can match satisfies this one too, so this one shadows it when evaluated first
+	bool Item::Covers(const Item* other) const
+	{
+		if (Narrows()) return false;
+		if (questItem.has_value() && questItem != other->questItem) return false;
+		if (miscComponent.has_value() && miscComponent != other->miscComponent) return false;
+		if (miscProduct.has_value() && miscProduct != other->miscProduct) return false;
+
+		if (!formIDs.empty() && (other->formIDs.empty() || !ra::all_of(other->formIDs, [&](const UInt32 refID) { return formIDs.contains(refID); })))
+			return false;
+
+		if (!formType.empty())
+		{
+			const auto typesCovered = !other->formType.empty() && ra::all_of(other->formType, [&](const UInt8 type) { return formType.contains(type); });
+			const auto formsCovered = !other->formIDs.empty() && ra::all_of(other->formIDs, [&](const UInt32 refID)
+			{
+				const auto form = TESForm::GetByID(refID);
+				return !form || formType.contains(form->typeID);
+			});
+			if (!typesCovered && !formsCovered) return false;
+		}
+
+		return true;
+	}
+
+	// describes conditions that cannot change the result, empty when there are none
+	std::string Item::CheckConditions() const
+	{
+		if (formIDs.empty() || formType.empty()) return "";
+
+		UInt32 typed = 0;
+		for (const auto refID : formIDs)
+			if (const auto form = TESForm::GetByID(refID); form && formType.contains(form->typeID)) typed++;
+
+		if (!typed) return "none of its forms has a listed formType, it never matches";
+		if (typed == formIDs.size()) return "formType is redundant, all of its forms have a listed type";
+		return "";
+	}
+
+	// true when no form can satisfy both rules, judged from formIDs, formType and questItem only
+	bool Item::Excludes(const Item* other) const
+	{
+		if (questItem.has_value() && other->questItem.has_value() && questItem.value() != other->questItem.value()) return true;
+		if (!formIDs.empty() && !other->formIDs.empty())
+			return ra::none_of(formIDs, [&](const UInt32 refID) { return other->formIDs.contains(refID); });
+		if (!formType.empty() && !other->formType.empty() && ra::none_of(formType, [&](const UInt8 type) { return other->formType.contains(type); }))
+			return true;
+		if (!formIDs.empty() && !other->formType.empty())
+			return ra::none_of(formIDs, [&](const UInt32 refID)
+			{
+				const auto form = TESForm::GetByID(refID);
+				return !form || other->formType.contains(form->typeID);
+			});
+		return false;
+	}
+
+	// swapping two neighbouring rules that commute never changes which rule a form matches first; a shared tag is not
+	// enough, the matched rule itself is what Item::Get hands out
+	bool Item::Commutes(const Item* other) const
+	{
+		return Excludes(other) || other->Excludes(this);
+	}
+
+	bool Aid::Narrows() const
+	{
+		return restoresAV || damagesAV || isAddictive || isFood || isWater || isPoisonous || isMedicine;
+	}
+
 	bool Item::IsValid() const
 	{
 		if (forms && formIDs.empty())
@@ -134,23 +218,196 @@ namespace SortingIcons
 		return categoryDefault;
 	}
 */
-	std::unordered_map<TESForm*, Item*> g_FormToItem;
+	// fixed capacity, open addressing over a short probe window, slots from an older generation count as free
+	class FormCache
+	{
+		struct Slot
+		{
+			TESForm*	form		= nullptr;
+			Item*		item		= nullptr;
+			UInt32		generation	= 0;
+		};
+
+		static constexpr UInt32 kProbes = 8;
+
+		std::vector<Slot>	slots;
+		UInt32				shift		= 32;
+		UInt32				generation	= 1;
+		UInt32				victim		= 0;
+
+		UInt32 Index(const TESForm* form) const
+		{
+			return static_cast<UInt32>(static_cast<UInt32>(reinterpret_cast<uintptr_t>(form)) * 0x9E3779B1u) >> shift;
+		}
+
+	public:
+		void Reserve(UInt32 capacity)
+		{
+			UInt32 bits = 4;
+			while (1u << bits < capacity && bits < 24) bits++;
+			slots.assign(1u << bits, Slot{});
+			shift = 32 - bits;
+		}
+
+		void Clear() { generation++; }
+
+		Item** Find(const TESForm* form)
+		{
+			if (slots.empty()) return nullptr;
+			const UInt32 mask = slots.size() - 1;
+			for (UInt32 i = 0, index = Index(form); i < kProbes; i++, index = index + 1 & mask)
+				if (auto& slot = slots[index]; slot.form == form && slot.generation == generation) return &slot.item;
+			return nullptr;
+		}
+
+		Item* Insert(TESForm* form, Item* item)
+		{
+			if (slots.empty()) Reserve(iCacheSize);
+			const UInt32 mask = slots.size() - 1;
+			const auto start = Index(form);
+
+			// when the whole window is taken by live entries one of them is replaced, rotating through the window
+			auto target = &slots[start + victim++ % kProbes & mask];
+			for (UInt32 i = 0, index = start; i < kProbes; i++, index = index + 1 & mask)
+				if (auto& slot = slots[index]; slot.generation != generation || slot.form == form)
+				{
+					target = &slot;
+					break;
+				}
+
+			*target = { form, item, generation };
+			return item;
+		}
+
+		template <typename F> UInt32 EraseIf(F&& predicate)
+		{
+			UInt32 erased = 0;
+			for (auto& slot : slots)
+				if (slot.generation == generation && predicate(slot.form, slot.item))
+				{
+					slot.generation = 0;
+					erased++;
+				}
+			return erased;
+		}
+	};
+
+	FormCache g_FormToItem;
+	// matches set by ySISetTrait, kept apart from the bounded cache so eviction, ClearCache and Reorder don't drop them
+	std::unordered_map<TESForm*, Item*> g_FormOverrides;
 	std::unordered_map<Tile*, Keyring*> g_TileToKey;
 
-	std::unordered_map<Object*, Icon*> g_ObjectToIcon;
+	void Item::ClearCache()
+	{
+		g_FormToItem.Clear();
+	}
 
 	Item* Item::Set(TESForm* form, Item* item)
 	{
-		return g_FormToItem[form] = item;
+		return g_FormToItem.Insert(form, item);
+	}
+
+	void Item::Override(TESForm* form, Item* item)
+	{
+		g_FormOverrides[form] = item;
+	}
+
+	ItemIndex<Item> g_ItemIndex;
+
+	void Item::BuildIndex()
+	{
+		g_ItemIndex.Build(g_Items);
+	}
+
+	// moves frequently matching rules ahead of their equal-priority neighbours, one commuting swap at a time
+	void Item::Reorder()
+	{
+		UInt32 moved = 0;
+		for (UInt32 i = 1; i < g_Items.size(); i++)
+			for (UInt32 j = i; j > 0; j--)
+			{
+				const auto& prev = g_Items[j - 1];
+				const auto& next = g_Items[j];
+				if (prev->priority != next->priority || prev->hits >= next->hits || !prev->Commutes(next.get())) break;
+				std::swap(g_Items[j - 1], g_Items[j]);
+				moved++;
+			}
+
+		if (!moved) return;
+		BuildIndex();
+		ClearCache();
+		Log(logLevel) << std::format("ySI: reordered rules by match count, {:d} swaps", moved);
+	}
+
+	// counters only advance on cache misses, so they reflect distinct forms per load rather than every lookup
+	void Item::DumpStats()
+	{
+#if SI_RULE_STATS
+		UInt32 unmatched = 0;
+		for (const auto& item : g_Items)
+		{
+			Log(logLevel) << std::format("ySI stats: tag '{:6s}', priority {:03d}, {}:{:d}, evaluated {:d}, matched {:d}",
+				item->tag, item->priority, item->file, item->fileIndex, item->evaluations, item->hits);
+			if (!item->hits) unmatched++;
+		}
+		Log(logLevel) << std::format("ySI stats: {:d} of {:d} rules never matched", unmatched, g_Items.size());
+#endif
+	}
+
+	// counters start from zero at every load, so lookups made while loading rules never count towards reordering
+	void Item::ResetStats()
+	{
+		for (const auto& item : g_Items)
+		{
+			item->hits = 0;
+#if SI_RULE_STATS
+			item->evaluations = 0;
+#endif
+		}
+	}
+
+	bool Evaluate(Item* item, TESForm* form)
+	{
+#if SI_RULE_STATS
+		item->evaluations++;
+#endif
+		return item->Satisfies(form);
+	}
+
+	Item* Hit(TESForm* form, Item* item)
+	{
+		item->hits++;
+		return Item::Set(form, item);
+	}
+
+	// evicts only the cached matches a file reload can have changed: matches to removed rules, and forms that a rule
+	// which now comes earlier (any added rule, or any rule of the reloaded file for matches within that file) satisfies
+	UInt32 Item::Invalidate(const std::unordered_set<const Item*>& removed, const std::string& file, const std::vector<Item*>& added)
+	{
+		std::vector<Item*> reloaded;
+		for (const auto& item : g_Items) if (item->file == file) reloaded.emplace_back(item.get());
+
+		std::erase_if(g_FormOverrides, [&](const auto& entry) { return removed.contains(entry.second); });
+
+		return g_FormToItem.EraseIf([&](TESForm* form, const Item* item)
+		{
+			if (!item) return ra::any_of(added, [&](const Item* candidate) { return candidate->Satisfies(form); });
+			if (removed.contains(item)) return true;
+			const auto& candidates = item->file == file ? reloaded : added;
+			return ra::any_of(candidates, [&](const Item* candidate) { return candidate->index < item->index && candidate->Satisfies(form); });
+		});
 	}
 
 	Item* Item::Get(TESForm* form)
 	{
-		if (g_FormToItem.contains(form)) return g_FormToItem[form];
+		if (!form) return nullptr;
+		if (const auto iter = g_FormOverrides.find(form); iter != g_FormOverrides.end()) return iter->second;
+		if (const auto cached = g_FormToItem.Find(form)) return *cached;
 
-		Item* assignedItem = nullptr;
-		for (const auto& item : g_Items) if (item->Satisfies(form)) return assignedItem = item.get();
-		return Set(form, assignedItem);
+		if (const auto item = g_ItemIndex.Find(form->refID, form->typeID, [&](Item* candidate) { return Evaluate(candidate, form); }))
+			return Hit(form, item);
+
+		return Set(form, nullptr);
 	}
 
 	Keyring* Keyring::Set(Tile* tile, Keyring* key)
@@ -167,16 +424,29 @@ namespace SortingIcons
 		return Set(tile, assignedItem);
 	}
 
-	bool Category::SatisfiesForm(TESForm* form) const
+	bool Category::SatisfiesType(UInt8 typeID) const
 	{
 		if (types.empty()) return true;
-		return tabMisc ? !types.contains(form->typeID) : types.contains(form->typeID);
+		return tabMisc ? !types.contains(typeID) : types.contains(typeID);
 	}
 
-	bool Category::SatisfiesTag(std::string tag) const
+	bool Category::SatisfiesForm(TESForm* form) const
+	{
+		return SatisfiesType(form->typeID);
+	}
+
+	bool Category::SatisfiesTag(UInt32 tagID) const
 	{
 		if (categories.empty()) return true;
-		return tabMisc ? !categories.contains(tag) : categories.contains(tag);
+		const auto contains = tagID < categoryIDs.size() && categoryIDs[tagID];
+		return tabMisc ? !contains : contains;
+	}
+
+	void Category::InternTags(const std::unordered_map<std::string, UInt32>& tagIDs)
+	{
+		categoryIDs.assign(tagIDs.size(), false);
+		for (const auto& category : categories)
+			if (const auto iter = tagIDs.find(category); iter != tagIDs.end()) categoryIDs[iter->second] = true;
 	}
 
 	bool Category::Satisfies(TESForm* form) const
@@ -184,30 +454,22 @@ namespace SortingIcons
 		if (!SatisfiesForm(form)) return false;
 		const auto item = Item::Get(form);
 		if (!item) return false;
-		if (!SatisfiesTag(item->tag)) return false;
+		if (!SatisfiesTag(item->tagID)) return false;
 		return true;
 	}
 
 	Icon* Icon::Set(Object* object, Icon* icon)
 	{
-		return g_ObjectToIcon[object] = icon;
+		if (object && object->tagID < g_TagToIcon.size()) g_TagToIcon[object->tagID] = icon;
+		return icon;
 	}
 
+	// icons are looked up by interned tag, g_Icons is in descending priority and the last icon for a tag wins
 	Icon* Icon::Get(Object* object)
 	{
-		if (g_ObjectToIcon.contains(object)) return g_ObjectToIcon[object];
-
-		auto categoryNew = categoryDefault;
-
-		if (object)
-		{
-			const auto tag = object->tag;
-			for (const auto& category : g_Icons)
-				if (category->tag == tag)
-					categoryNew = category.get();
-		}
-
-		return Set(object, categoryNew);
+		if (!object || object->tagID >= g_TagToIcon.size()) return categoryDefault;
+		if (const auto icon = g_TagToIcon[object->tagID]) return icon;
+		return categoryDefault;
 	}
 }
 
@@ -216,7 +478,32 @@ namespace SortingIcons::Keyrings
 	Tab* openTab;
 	std::string stringStewie;
 
-	std::unordered_map<Keyring*, UInt32> itemCountsForKeyrings;
+	// keyring membership is split into a form type half and a tag half, hiding an entry is an AND of the two
+	std::array<UInt64, 0x100> typeToKeyrings{};
+
+	std::vector<UInt32> keyringCounts;
+	UInt64 keyringsPresent = 0;
+
+	void BuildMasks()
+	{
+		if (g_Keyrings.size() > 64) Log(logLevel) << "ySI: only the first 64 keyrings are used";
+		const UInt32 count = std::min<UInt32>(g_Keyrings.size(), 64);
+
+		typeToKeyrings.fill(0);
+		for (UInt32 type = 0; type < typeToKeyrings.size(); type++)
+			for (UInt32 i = 0; i < count; i++)
+				if (g_Keyrings[i]->SatisfiesType(type)) typeToKeyrings[type] |= 1ull << i;
+
+		for (const auto& item : g_Items)
+		{
+			item->keyrings = 0;
+			for (UInt32 i = 0; i < count; i++)
+				if (g_Keyrings[i]->SatisfiesTag(item->tagID)) item->keyrings |= 1ull << i;
+		}
+
+		keyringCounts.assign(count, 0);
+		keyringsPresent = 0;
+	}
 
 	bool update = false;
 
@@ -229,7 +516,7 @@ namespace SortingIcons::Keyrings
 	{
 		if (!tile) {}
 		else if (g_TileToKey.contains(tile))
-			openTab = g_StringToTabs[g_TileToKey[tile]->tag];
+			openTab = g_TagToTab[g_TileToKey[tile]->tagID];
 		return *(UInt32*)0x011D9EB8;
 	}
 
@@ -245,9 +532,11 @@ namespace SortingIcons::Keyrings
 		if (!update) for (const auto list = inventoryMenu->itemsList.list; const auto iter : list)
 			if (iter->tile && g_TileToKey.contains(iter->tile)) { g_TileToKey.erase(iter->tile); iter->tile->~Tile(); list.RemoveItem(iter); }
 
-		for (const auto& key : itemCountsForKeyrings | std::views::keys)
+		for (auto present = keyringsPresent; present; present &= present - 1)
 		{
-			const auto keys = itemCountsForKeyrings[key];
+			const auto i = std::countr_zero(present);
+			const auto key = g_Keyrings[i];
+			const auto keys = keyringCounts[i];
 
 			std::string keyringname = key->name;
 			if (keyringname.find("&-") == 0) keyringname = GetGameSetting(keyringname.substr(2, keyringname.length() - 3))->GetAsString();
@@ -258,11 +547,14 @@ namespace SortingIcons::Keyrings
 			tile->Set(kTileValue_id, 30);
 			g_TileToKey[tile] = key;
 //			tile->Set(kTileValue_user16, key->tag);
-			inventoryMenu->itemsList.SortAlt(listItem, reinterpret_cast<ListBox<InventoryChanges>::SortingFunction>(0x7824E0));
 			Icons::InjectIconTile(Icon::Get(key), tile);
 		}
 
-		itemCountsForKeyrings.clear();
+		// keyring tiles are placed with a single sort once all of them are in, instead of re-sorting after each one
+		if (keyringsPresent) inventoryMenu->itemsList.Sort(reinterpret_cast<ListBox<InventoryChanges>::SortingFunction>(0x7824E0));
+
+		ra::fill(keyringCounts, 0);
+		keyringsPresent = 0;
 
 		update = false;
 		ThisCall(0x71A670, &inventoryMenu->itemsList);
@@ -291,18 +583,26 @@ namespace SortingIcons::Keyrings
 	{
 		const auto form = entry->form->TryGetREFRParent();
 
-		bool shouldHide = false;
-		for (const auto& keyring : g_Keyrings)
+		const auto item = Item::Get(form);
+		if (!item) return false;
+
+		auto keyrings = typeToKeyrings[form->typeID] & item->keyrings;
+		if (!keyrings) return false;
+
+		for (; keyrings; keyrings &= keyrings - 1)
 		{
-			if (!keyring->Satisfies(form)) continue;
+			const auto i = std::countr_zero(keyrings);
+			const auto keyring = g_Keyrings[i];
+
+			if (keyring->keyring == 1) keyringCounts[i] = 1;
+			else if (keyring->keyring == 2) keyringCounts[i] += 1;
+			else if (keyring->keyring == 3) keyringCounts[i] += entry->countDelta;
+			else continue;
 
-			shouldHide = true;
-			if (keyring->keyring == 1) itemCountsForKeyrings[keyring] = 1;
-			else if (keyring->keyring == 2) itemCountsForKeyrings[keyring] += 1;
-			else if (keyring->keyring == 3) itemCountsForKeyrings[keyring] += entry->countDelta;
+			keyringsPresent |= 1ull << i;
 		}
 
-		return shouldHide;
+		return true;
 	}
 
 
@@ -550,50 +850,38 @@ namespace SortingIcons::Keyrings::Hook
 
 namespace SortingIcons::Tabs
 {
-//	std::unordered_map<TESForm*, std::unordered_set<TabPtr>> g_ItemToTabs;
+	// tab membership uses the same type and tag split as keyrings, bit per g_Tabline index
+	std::array<UInt64, 0x100> typeToTabs{};
+	UInt64 untaggedTabs = 0;
 
-	void ItemAssignTabs(TESForm* form)
+	void BuildMasks()
 	{
-		std::unordered_set<Tab*> set;
-/*
-		for (const auto& iter : g_Tabs) {
-			const auto& entry = *iter;
-//			if (!entry.tabMisc.empty()) continue;
-			if (!entry.types.empty() && !entry.types.contains(form->typeID)) continue;
-//			if (!entry.categories.empty() && !entry.categories.contains(Categories::ItemGetCategory(form)->category)) continue;
-			set.emplace(iter);
-		}
-
-		for (const auto& iter : g_Tabs) {
-			const auto& entry = *iter;
-//			if (entry.tabMisc.empty()) continue;
-			bool misc = true;
-			for (const auto& it : entry.tabMisc) if (set.contains(g_StringToTabs[it])) { misc = false; break; }
-			if (misc) set.emplace(iter);
-		}
+		if (g_Tabline.size() > 64) Log(logLevel) << "ySI: only the first 64 tabs are used";
+		const UInt32 count = std::min<UInt32>(g_Tabline.size(), 64);
 
-		g_ItemToTabs.emplace(form, std::move(set));*/
-	}
+		typeToTabs.fill(0);
+		for (UInt32 type = 0; type < typeToTabs.size(); type++)
+			for (UInt32 i = 0; i < count; i++)
+				if (g_Tabline[i]->SatisfiesType(type)) typeToTabs[type] |= 1ull << i;
 
-	void ItemAssignTabs(const InventoryChanges* entry)
-	{
-		return ItemAssignTabs(entry->form->TryGetREFRParent());
-	}
+		untaggedTabs = 0;
+		for (UInt32 i = 0; i < count; i++)
+			if (g_Tabline[i]->SatisfiesTag(UINT32_MAX)) untaggedTabs |= 1ull << i;
 
-	bool ItemHasTabs(TESForm* form)
-	{
-		if (!form) return false;
-//		if (!g_ItemToTabs.contains(form)) return false;
-		return true;
+		for (const auto& item : g_Items)
+		{
+			item->tabs = 0;
+			for (UInt32 i = 0; i < count; i++)
+				if (g_Tabline[i]->SatisfiesTag(item->tagID)) item->tabs |= 1ull << i;
+		}
 	}
 
-	bool ItemHasTabs(const InventoryChanges* entry)
+	UInt64 GetTabs(TESForm* form)
 	{
-		if (!entry) return false;
-		return ItemHasTabs(entry->form->TryGetREFRParent());
+		const auto item = Item::Get(form);
+		return typeToTabs[form->typeID] & (item ? item->tabs : untaggedTabs);
 	}
 
-
 	std::vector<Tile*> tablineTiles;
 
 	void SetUpTabline(TileRect* tabline, int traitID, const char* strWeapon, const char* strApparel, const char* strAid,
@@ -686,12 +974,10 @@ namespace SortingIcons::Tabs
 		if (!entry || !entry->form) return true;
 
 		const auto filter = InventoryMenu::GetSingleton()->filter;
-		if (!Tabs::ItemHasTabs(entry)) Tabs::ItemAssignTabs(entry);
+		if (filter >= g_Tabline.size() || filter >= 64) return true;
 		//	if (SI::g_Tabs[SI::g_Tabline[filter]].tabNew) return false;
 
-//		if (Tabs::g_ItemToTabs[entry->form].contains(g_Tabline[filter])) return false;
-
-		return true;
+		return !(Tabs::GetTabs(entry->form->TryGetREFRParent()) & 1ull << filter);
 	}
 }
 
@@ -790,40 +1076,68 @@ namespace SortingIcons::Tabs::Hook
 
 namespace SortingIcons::Sorting
 {
-	SInt32 CompareWithTags(const ListBoxItem<InventoryChanges>* item1, const ListBoxItem<InventoryChanges>* item2)
+	// everything CompareItems looks at, gathered once per entry instead of once per comparison
+	struct SortKey
 	{
+		UInt32				tag			= 0;		// tagID + 1, 0 when untagged
+		UInt64				prefix		= 0;		// first 8 name bytes, big-endian so integer order is string order
+		const char*			name		= "";
+		TESForm*			form		= nullptr;
+
+		UInt8				weaponMod	= 0;
+		Float64				health		= 0;
+		bool				equipped	= false;
+	};
+
+	SortKey MakeKey(Tile* tile, InventoryChanges* entry)
+	{
+		SortKey key;
+
+		if (entry && entry->form) key.form = entry->form->TryGetREFRParent();
+
 		if (bSort)
 		{
-			const auto [tile1, entry1, byte1, pad1] = *item1;
-			const auto [tile2, entry2, byte2, pad2] = *item2;
+			const Object* tag = key.form ? Item::Get(key.form) : nullptr;
+			if (!tag && !entry && bCategories && !g_Keyrings.empty()) tag = Keyring::Get(tile);
+			if (tag) key.tag = tag->tagID + 1;
+		}
 
-			const Object* tag1 = nullptr;
-			const Object* tag2 = nullptr;
+		if (key.form)
+			if (const auto name = key.form->GetTheName()) key.name = name;
+		if (!*key.name && tile && tile->GetValue(kTileValue_string)) key.name = tile->GetValue(kTileValue_string)->str;
 
-			if (entry1 && entry1->form)
-				if (const auto form1 = entry1->form->TryGetREFRParent())
-					if (const auto category1 = Item::Get(form1)) 
-						tag1 = category1;
-			if (entry2 && entry2->form)
-				if (const auto form2 = entry2->form->TryGetREFRParent())
-					if (const auto category2 = Item::Get(form2))
-						tag2 = category2;
+		for (UInt32 i = 0; i < 8 && key.name[i]; i++)
+			key.prefix |= static_cast<UInt64>(static_cast<UInt8>(key.name[i])) << (56 - 8 * i);
 
-			if (bCategories && !g_Keyrings.empty())
-			{
-				if (!tag1 && !entry1)
-				{
-					tag1 = Keyring::Get(tile1);
-				}
-				if (!tag2 && !entry2)
-				{
-					tag2 = Keyring::Get(tile2);
-				}
-			}
+		return key;
+	}
 
-			if (const auto cmp = Object::Compare(tag1, tag2); cmp != 0) return cmp;
+	void FillDetails(SortKey& key, InventoryChanges* entry)
+	{
+		if (!key.form) return;
+		key.weaponMod = entry->GetWeaponMod();
+		key.health = entry->GetHealthPercent();
+		key.equipped = entry->GetEquipped();
+	}
+
+	SInt32 CompareNames(const SortKey& key1, const SortKey& key2)
+	{
+		if (key1.tag != key2.tag) return key1.tag < key2.tag ? -1 : 1;
+		if (key1.prefix != key2.prefix) return key1.prefix < key2.prefix ? -1 : 1;
+		if (const auto cmp = strcmp(key1.name, key2.name)) return cmp < 0 ? -1 : 1;
+		return 0;
+	}
+
+	SInt32 CompareDetails(const SortKey& key1, const SortKey& key2)
+	{
+		if (!key1.form) return key2.form ? -1 : 0;
+		if (!key2.form) return 1;
+
+		if (key1.weaponMod != key2.weaponMod) return key2.weaponMod < key1.weaponMod ? -1 : 1;
+		if (key1.health != key2.health) return key2.health < key1.health ? -1 : 1;
+		if (key1.equipped != key2.equipped) return key2.equipped < key1.equipped ? -1 : 1;
+		if (key1.form->refID != key2.form->refID) return key2.form->refID < key1.form->refID ? -1 : 1;
 
-		}
 		return 0;
 	}
 
@@ -832,32 +1146,53 @@ namespace SortingIcons::Sorting
 		const auto [tile1, entry1, byte1, pad1] = *item1;
 		const auto [tile2, entry2, byte2, pad2] = *item2;
 
-		TESForm* form1 = nullptr, *form2 = nullptr;
+		auto key1 = MakeKey(tile1, entry1);
+		auto key2 = MakeKey(tile2, entry2);
 
-		if (entry1 && entry1->form) form1 = entry1->form->TryGetREFRParent();
-		if (entry2 && entry2->form) form2 = entry2->form->TryGetREFRParent();
+		if (const auto cmp = CompareNames(key1, key2)) return cmp;
 
-		if (const auto cmp = CompareWithTags(item1, item2)) return cmp;
+		// the engine sorts through this comparator, so entry details are only queried on a name tie
+		FillDetails(key1, entry1);
+		FillDetails(key2, entry2);
 
-		std::string name1, name2;
+		return CompareDetails(key1, key2);
+	}
 
-		if (form1) name1 = form1->GetTheName();
-		if (form2) name2 = form2->GetTheName();
+	// radix sorts on tag and name prefix, only entries sharing both still need strcmp and the detail comparison
+	void Sort(std::vector<InventoryChanges*>& entries)
+	{
+		std::vector<SortKey> keys;
+		keys.reserve(entries.size());
+		for (const auto entry : entries)
+		{
+			auto key = MakeKey(nullptr, entry);
+			FillDetails(key, entry);
+			keys.emplace_back(key);
+		}
 
-		if (name1.empty() && tile1->GetValue(kTileValue_string)) name1 = tile1->GetValue(kTileValue_string)->str;
-		if (name2.empty() && tile2->GetValue(kTileValue_string)) name2 = tile2->GetValue(kTileValue_string)->str;
+		const auto less = [&](const UInt32 lhs, const UInt32 rhs)
+		{
+			if (const auto cmp = CompareNames(keys[lhs], keys[rhs])) return cmp < 0;
+			return CompareDetails(keys[lhs], keys[rhs]) < 0;
+		};
 
-		if (const auto cmp = name1 <=> name2; cmp != 0) return cmp._Value;
+		std::vector<std::pair<UInt64, UInt32>> packed;
+		packed.reserve(keys.size());
+		for (UInt32 i = 0; i < keys.size(); i++) packed.emplace_back(PackSortKey(keys[i].tag, keys[i].name), i);
 
-		if (!form1) return form2 ? -1 : 0;
-		if (!form2) return 1;
-		
-		if (const auto weaponMods = entry2->GetWeaponMod() <=> entry1->GetWeaponMod(); weaponMods != 0) return weaponMods._Value;
-		if (const auto condition = entry2->GetHealthPercent() <=> entry1->GetHealthPercent(); condition != 0) return condition._Value;
-		if (const auto equipped = entry2->GetEquipped() <=> entry1->GetEquipped(); equipped != 0) return equipped._Value;
-		if (const auto refID = form2->refID <=> form1->refID; refID != 0) return refID._Value;
+		// more tags than the key has room for, which no real rule set reaches
+		if (ra::any_of(keys, [](const SortKey& key) { return key.tag > kPackedTagMax; }))
+			std::sort(packed.begin(), packed.end(), [&](const std::pair<UInt64, UInt32>& lhs, const std::pair<UInt64, UInt32>& rhs) { return less(lhs.second, rhs.second); });
+		else
+		{
+			RadixSort(packed);
+			SortRuns(packed, less);
+		}
 
-		return 0;
+		std::vector<InventoryChanges*> sorted;
+		sorted.reserve(entries.size());
+		for (const auto& [key, index] : packed) sorted.emplace_back(entries[index]);
+		entries = std::move(sorted);
 	}
 }
 
@@ -0,0 +1,50 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace SortingIcons::Sorting
+{
+	// tag ID in the top 16 bits, the first 6 name bytes below it big-endian so integer order is tag then strcmp order
+	constexpr UInt32 kPackedTagMax		= 0xFFFF;
+	constexpr UInt32 kPackedNameBytes	= 6;
+
+	inline UInt64 PackSortKey(const UInt32 tag, const char* name)
+	{
+		UInt64 key = static_cast<UInt64>(tag) << 48;
+		for (UInt32 i = 0; i < kPackedNameBytes && name[i]; i++)
+			key |= static_cast<UInt64>(static_cast<UInt8>(name[i])) << (40 - 8 * i);
+		return key;
+	}
+
+	// LSD radix sort over the 64-bit keys, a byte per pass, skipping passes where every key has the same byte; stable
+	template <typename T> void RadixSort(std::vector<std::pair<UInt64, T>>& keyed)
+	{
+		if (keyed.size() < 2) return;
+
+		std::vector<std::pair<UInt64, T>> buffer(keyed.size());
+		for (UInt32 shift = 0; shift < 64; shift += 8)
+		{
+			std::array<UInt32, 0x100> offsets{};
+			for (const auto& entry : keyed) offsets[entry.first >> shift & 0xFF]++;
+			if (offsets[keyed.front().first >> shift & 0xFF] == keyed.size()) continue;
+
+			UInt32 offset = 0;
+			for (auto& count : offsets) offset += std::exchange(count, offset);
+			for (auto& entry : keyed) buffer[offsets[entry.first >> shift & 0xFF]++] = std::move(entry);
+			keyed.swap(buffer);
+		}
+	}
+
+	// orders each run of equal keys with the full comparison, the radix pass has already ordered the runs themselves
+	template <typename T, typename Less> void SortRuns(std::vector<std::pair<UInt64, T>>& keyed, Less less)
+	{
+		for (auto run = keyed.begin(); run != keyed.end();)
+		{
+			const auto end = std::find_if(run, keyed.end(), [&](const std::pair<UInt64, T>& entry) { return entry.first != run->first; });
+			if (end - run > 1) std::sort(run, end, [&](const std::pair<UInt64, T>& lhs, const std::pair<UInt64, T>& rhs) { return less(lhs.second, rhs.second); });
+			run = end;
+		}
+	}
+}
@@ -0,0 +1,225 @@
+#pragma once
+#include <json.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace SortingIcons::Files
+{
+	// walks a rule file as SAX events and hands each element of its top-level arrays to the handler as soon as the element
+	// is complete, so a rule is only ever held as a small DOM of its own and the file never as a whole document
+	// Handler supplies Array(key) when a top-level array starts, Element(key, json&&) for each of its elements, returning
+	// false to stop, and Value(key, json&&) for every other top-level value; a root that is not an object yields nothing
+	template <typename Handler> class RuleStream : public nlohmann::json_sax<nlohmann::json>
+	{
+		using json = nlohmann::json;
+
+		Handler&				handler;
+		UInt32					depth = 0;			// containers open outside the value being built, the root is 1
+		bool					root = false;		// the root is an object, its members are handed over
+		bool					inArray = false;	// inside a top-level array, values are elements
+		std::string				section;			// top-level key the current value belongs to
+		json					value;				// element or top-level value being built
+		std::vector<json*>		open;				// containers of value still open, innermost last
+		json*					slot = nullptr;		// member the last key of the innermost object named
+
+		json* Put(json&& val)
+		{
+			if (open.empty()) return &(value = std::move(val));
+			auto& parent = *open.back();
+			if (parent.is_array()) return &parent.emplace_back(std::move(val));
+			return &(*slot = std::move(val));
+		}
+
+		// a complete value, either an element of a top-level array or a top-level value itself
+		bool Deliver(json&& val)
+		{
+			if (!root) return true;
+			if (inArray) return handler.Element(section, std::move(val));
+			if (depth == 1) handler.Value(section, std::move(val));
+			return true;
+		}
+
+		bool Scalar(json&& val)
+		{
+			if (!open.empty())
+			{
+				Put(std::move(val));
+				return true;
+			}
+			return Deliver(std::move(val));
+		}
+
+		bool Start(json&& container, const bool array)
+		{
+			if (open.empty())
+			{
+				if (depth == 0) root = !array;
+				// the top-level arrays themselves are never built, only their elements
+				if (!root || depth == 0 || (depth == 1 && array))
+				{
+					if (root && depth == 1) handler.Array(section);
+					inArray = root && depth == 1;
+					depth++;
+					return true;
+				}
+			}
+			open.push_back(Put(std::move(container)));
+			return true;
+		}
+
+		bool End()
+		{
+			if (open.empty())
+			{
+				if (--depth == 1) inArray = false;
+				return true;
+			}
+			open.pop_back();
+			if (!open.empty()) return true;
+			return Deliver(std::move(value));
+		}
+
+	public:
+		std::string				error;
+
+		RuleStream(Handler& handler) : handler(handler) {}
+
+		bool null() override { return Scalar(nullptr); }
+		bool boolean(bool val) override { return Scalar(val); }
+		bool number_integer(number_integer_t val) override { return Scalar(val); }
+		bool number_unsigned(number_unsigned_t val) override { return Scalar(val); }
+		bool number_float(number_float_t val, const string_t&) override { return Scalar(val); }
+		bool string(string_t& val) override { return Scalar(std::move(val)); }
+		bool binary(binary_t& val) override { return Scalar(json::binary(std::move(val))); }
+
+		bool start_object(std::size_t) override { return Start(json::object(), false); }
+		bool start_array(std::size_t) override { return Start(json::array(), true); }
+		bool end_object() override { return End(); }
+		bool end_array() override { return End(); }
+
+		bool key(string_t& val) override
+		{
+			if (open.empty()) section = val;
+			else slot = &(*open.back())[val];
+			return true;
+		}
+
+		bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override
+		{
+			error = ex.what();
+			return false;
+		}
+	};
+
+	// writes SAX events straight out as MessagePack, so text is turned into the cached form without building a document
+	// container sizes are unknown when they open, so every map and array is written with a 32-bit count patched at its end
+	class MsgPackWriter : public nlohmann::json_sax<nlohmann::json>
+	{
+		std::vector<UInt8>&						output;
+		std::vector<std::pair<UInt32, UInt32>>	open;		// count offset and element count of every open container
+
+		template <typename T> void Write(const UInt8 marker, const T val)
+		{
+			output.push_back(marker);
+			for (UInt32 i = sizeof(T); i--;) output.push_back(static_cast<UInt8>(static_cast<UInt64>(val) >> (8 * i)));
+		}
+
+		// a value inside an array counts as an element, inside a map the key already counted the pair
+		void Count()
+		{
+			if (!open.empty() && open.back().first & 0x80000000) open.back().second++;
+		}
+
+		bool Start(const UInt8 marker, const bool array)
+		{
+			Count();
+			output.push_back(marker);
+			open.emplace_back(static_cast<UInt32>(output.size()) | (array ? 0x80000000 : 0), 0);
+			output.resize(output.size() + 4);
+			return true;
+		}
+
+		bool End()
+		{
+			const auto [offset, count] = open.back();
+			open.pop_back();
+			for (UInt32 i = 0; i < 4; i++) output[(offset & 0x7FFFFFFF) + i] = static_cast<UInt8>(count >> (24 - 8 * i));
+			return true;
+		}
+
+		void WriteString(const std::string& val, const UInt8 fix, const UInt8 marker8)
+		{
+			const auto size = val.size();
+			if (fix && size < 32) output.push_back(fix | static_cast<UInt8>(size));
+			else if (size <= 0xFF) Write(marker8, static_cast<UInt8>(size));
+			else if (size <= 0xFFFF) Write(marker8 + 1, static_cast<UInt16>(size));
+			else Write(marker8 + 2, static_cast<UInt32>(size));
+			output.insert(output.end(), val.begin(), val.end());
+		}
+
+	public:
+		std::string								error;
+
+		MsgPackWriter(std::vector<UInt8>& output) : output(output) {}
+
+		bool null() override { Count(); output.push_back(0xC0); return true; }
+		bool boolean(bool val) override { Count(); output.push_back(val ? 0xC3 : 0xC2); return true; }
+
+		bool number_integer(number_integer_t val) override
+		{
+			if (val >= 0) return number_unsigned(static_cast<number_unsigned_t>(val));
+			Count();
+			if (val >= -32) output.push_back(static_cast<UInt8>(val));
+			else if (val >= INT8_MIN) Write(0xD0, static_cast<UInt8>(val));
+			else if (val >= INT16_MIN) Write(0xD1, static_cast<UInt16>(val));
+			else if (val >= INT32_MIN) Write(0xD2, static_cast<UInt32>(val));
+			else Write(0xD3, static_cast<UInt64>(val));
+			return true;
+		}
+
+		bool number_unsigned(number_unsigned_t val) override
+		{
+			Count();
+			if (val < 0x80) output.push_back(static_cast<UInt8>(val));
+			else if (val <= 0xFF) Write(0xCC, static_cast<UInt8>(val));
+			else if (val <= 0xFFFF) Write(0xCD, static_cast<UInt16>(val));
+			else if (val <= 0xFFFFFFFF) Write(0xCE, static_cast<UInt32>(val));
+			else Write(0xCF, static_cast<UInt64>(val));
+			return true;
+		}
+
+		bool number_float(number_float_t val, const string_t&) override
+		{
+			Count();
+			UInt64 bits;
+			static_assert(sizeof(bits) == sizeof(val));
+			memcpy(&bits, &val, sizeof(bits));
+			Write(0xCB, bits);
+			return true;
+		}
+
+		bool string(string_t& val) override { Count(); WriteString(val, 0xA0, 0xD9); return true; }
+		bool binary(binary_t& val) override { Count(); WriteString({ val.begin(), val.end() }, 0, 0xC4); return true; }
+
+		bool start_object(std::size_t) override { return Start(0xDF, false); }
+		bool start_array(std::size_t) override { return Start(0xDD, true); }
+		bool end_object() override { return End(); }
+		bool end_array() override { return End(); }
+
+		bool key(string_t& val) override
+		{
+			open.back().second++;
+			WriteString(val, 0xA0, 0xD9);
+			return true;
+		}
+
+		bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override
+		{
+			error = ex.what();
+			return false;
+		}
+	};
+}
@@ -10,29 +10,49 @@ namespace SortingIcons::Icons
 {
 	Float32 compassRoseX = 0, compassRoseY = 0;
 	
+	// the HUD needs the prompt template before any menu opens, item menus get the files on their first icon
 	void InjectTemplates()
 	{
-		for (const auto& iter : g_XMLPaths)
-		{
-			HUDMainMenu::GetSingleton()->tile->InjectUIXML(iter);
-			RepairMenu::GetSingleton()->tile->InjectUIXML(iter);
-			InventoryMenu::GetSingleton()->tile->InjectUIXML(iter);
-		}
+		for (const auto& iter : g_XMLPaths) HUDMainMenu::GetSingleton()->tile->InjectUIXML(iter);
 	}
 
+	// menu type and template name pairs the files don't define, so a bad template name doesn't reparse them for every item
+	std::set<std::pair<UInt32, std::string>> missingTemplates;
+
 	bool InjectTemplatesToMenu(TileMenu* tilemenu, const std::string& templateName) {
 		if (const auto menu = tilemenu->menu; !menu->GetTemplateExists(templateName))
 		{
-			if (menu->id != kMenuType_Barter && menu->id != kMenuType_Container && menu->id != kMenuType_RepairServices) return false;
+			if (menu->id != kMenuType_Inventory && menu->id != kMenuType_Repair
+				&& menu->id != kMenuType_Barter && menu->id != kMenuType_Container && menu->id != kMenuType_RepairServices) return false;
+			if (missingTemplates.contains({ menu->id, templateName })) return false;
 			for (auto& iter : g_XMLPaths) tilemenu->InjectUIXML(iter);
-			if (!menu->GetTemplateExists(templateName)) return false;
+			if (!menu->GetTemplateExists(templateName))
+			{
+				missingTemplates.emplace(menu->id, templateName);
+				Log(logLevel) << std::format("ySI: template '{}' not found in any ySI xml file", templateName);
+				return false;
+			}
 		}
 		return true;
 	}
 
+	// list tiles are refilled on every scroll and refilter while their icon rarely changes, and each write makes the
+	// game re-evaluate every value depending on it, so values already holding the icon's settings are left alone
+	void SetIfChanged(Tile* tile, TileValueIDs id, const std::string& value, bool propagate)
+	{
+		if (const auto current = tile->GetValue(id); current && current->str && value == current->str) return;
+		tile->Set(id, value, propagate);
+	}
+
+	void SetIfChanged(Tile* tile, TileValueIDs id, Float32 value, bool propagate)
+	{
+		if (tile->GetValue(id) && tile->Get(id) == value) return;
+		tile->Set(id, value, propagate);
+	}
+
 	void InjectIconTile(const Icon* category, Tile* tile)
 	{
-		if (!category->IsValid()) return;
+		if (!category || !category->IsValid()) return;
 
 		const auto& tag = category->tag;
 		const auto priority = category->priority;
@@ -62,20 +82,20 @@ namespace SortingIcons::Icons
 			if (!icon) return;
 		}
 
-		if (!filename.empty()) icon->Set(kTileValue_filename, filename, false);
-		if (!texatlas.empty()) icon->Set(kTileValue_texatlas, texatlas, false);
-		if (font.has_value()) icon->Set(kTileValue_texatlas, font.value(), false);
+		if (!filename.empty()) SetIfChanged(icon, kTileValue_filename, filename, false);
+		if (!texatlas.empty()) SetIfChanged(icon, kTileValue_texatlas, texatlas, false);
+		if (font.has_value()) SetIfChanged(icon, kTileValue_font, static_cast<Float32>(font.value()), false);
 		if (systemcolor.has_value())
-			icon->Set(kTileValue_systemcolor, systemcolor.value(), false);
+			SetIfChanged(icon, kTileValue_systemcolor, static_cast<Float32>(systemcolor.value()), false);
 		else
-			icon->Set(kTileValue_systemcolor, menu->Get(kTileValue_systemcolor));
+			SetIfChanged(icon, kTileValue_systemcolor, menu->Get(kTileValue_systemcolor), true);
 
 		const Float32 x = text->Get(kTileValue_x);
 		Float32 width = 0;
 
 		if (icon->GetValue(kTileValue_user0)) width += icon->Get(kTileValue_user0);
 
-		icon->Set(kTileValue_x, x + width, true);
+		SetIfChanged(icon, kTileValue_x, x + width, true);
 
 		width += icon->Get(kTileValue_width);
 
@@ -104,7 +124,7 @@ namespace SortingIcons::Icons
 		}
 
 		const auto category = Icon::Get(Item::Get(entry->form));
-		tile->Set(tilevalue, category->IsValid() && !category->filename.empty() ? category->filename.c_str() : src, propagate);
+		tile->Set(tilevalue, category && category->IsValid() && !category->filename.empty() ? category->filename.c_str() : src, propagate);
 	}
 
 	void __fastcall TagRoseSetStringValue(Tile* tile, InventoryChanges* entry, TileValueIDs tilevalue, char* src, char propagate)
@@ -121,7 +141,7 @@ namespace SortingIcons::Icons
 		tile->Set(kTileValue_y, compassRoseY + 3, propagate);
 
 		const auto category = Icon::Get(Item::Get(entry->form));
-		tile->Set(tilevalue, category->IsValid() && !category->filename.empty() ? category->filename.c_str() : src, propagate);
+		tile->Set(tilevalue, category && category->IsValid() && !category->filename.empty() ? category->filename.c_str() : src, propagate);
 	}
 
 
@@ -135,17 +155,16 @@ namespace SortingIcons::Icons
 
 		auto icon = tile->GetChild("ySIImage");
 		if (!icon) icon = tile->AddTileFromTemplate("ySIDefault");
-		if (!item || !item->IsInventoryObjectAlt() || !category->IsValid())
+		if (!item || !item->IsInventoryObjectAlt() || !category || !category->IsValid())
 		{
 			icon->Set(kTileValue_visible, false, true);
 			return;
 		}
-		const auto fontManager = FontManager::GetSingleton();
 		const auto string = tile->GetValue(kTileValue_string)->str;
 		const auto wrapwidth = tile->Get(kTileValue_wrapwidth);
-		const auto stringDimensions = fontManager->GetStringDimensions(string, 7, wrapwidth);
+		const auto stringDimensions = TextDimensions::Get(string, 7, wrapwidth);
 
-		icon->Set(kTileValue_x, -stringDimensions->x / 2 - icon->Get(kTileValue_width) - icon->Get(kTileValue_user1));
+		icon->Set(kTileValue_x, -stringDimensions.x / 2 - icon->Get(kTileValue_width) - icon->Get(kTileValue_user1));
 		icon->Set(kTileValue_y, - icon->Get(kTileValue_user2));
 		icon->Set(kTileValue_visible, true, true);
 		icon->Set(kTileValue_systemcolor, tile->Get(kTileValue_systemcolor));
@@ -0,0 +1,494 @@
+#include "Test.h"
+#include "SortingIcons/SortingIconsItemIndex.h"
+#include "SortingIcons/SortingIconsRadix.h"
+
+#include <json.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+// the rule files shipped with yUI, matched against a mock form model shaped like the game's
+// the rule conditions mirror Item, Weapon, Armor and Aid::Satisfies, which read game classes and can't be built here;
+// the index, the packed sort key and the radix sort are the plugin's own headers
+
+using namespace SortingIcons;
+
+constexpr UInt8 kFormType_TESObjectARMO		= 0x18;
+constexpr UInt8 kFormType_TESObjectWEAP		= 0x28;
+constexpr UInt8 kFormType_AlchemyItem		= 0x2F;
+
+const char* const kRuleFiles[] = { "ySI.json", "taleoftwowastelands.json", "sawyer.json", "viciouswastes.json" };
+
+using Clock = std::chrono::steady_clock;
+
+long long Micro(const Clock::time_point since) { return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count(); }
+
+// TESForm and the three form classes the rules look into, with the values the conditions read
+struct MockForm
+{
+	UInt32			refID = 0;
+	UInt8			typeID = 0;
+	bool			questItem = false;
+	bool			component = false;
+	bool			product = false;
+	std::string		name;
+
+	virtual ~MockForm() = default;
+};
+
+struct MockWeapon : MockForm
+{
+	UInt32	skill = 0, type = 0, handgrip = 0, attackAnim = 0, reloadAnim = 0, soundLevel = 0, clipRounds = 0, numProjectiles = 1, ammo = 0;
+	bool	automatic = false, scope = false, ignoresDTDR = false;
+};
+
+struct MockArmor : MockForm
+{
+	UInt32	slots = 0, armorClass = 0, power = 0, backpack = 0, dr = 0;
+	float	dt = 0;
+};
+
+struct MockAid : MockForm
+{
+	UInt32	restores = 0, damages = 0;
+	bool	addictive = false, food = false, water = false, poison = false, medicine = false;
+};
+
+// mod name -> load order index, in the order the rule files first name them
+std::unordered_map<std::string, UInt32> g_ModIndices;
+
+UInt32 ResolveForm(const nlohmann::json& mod, const nlohmann::json& form)
+{
+	const auto [iter, inserted] = g_ModIndices.try_emplace(mod.get<std::string>(), g_ModIndices.size());
+	return iter->second << 24 | (std::stoul(form.get<std::string>(), nullptr, 16) & 0xFFFFFF);
+}
+
+template <typename T> std::unordered_set<T> GetSet(const nlohmann::json& elem)
+{
+	std::unordered_set<T> set;
+	if (!elem.is_array()) set.insert(elem.get<T>());
+	else for (const auto& i : elem) set.insert(i.get<T>());
+	return set;
+}
+
+std::unordered_set<UInt32> GetForms(const nlohmann::json& mod, const nlohmann::json& form)
+{
+	std::unordered_set<UInt32> forms;
+	if (!form.is_array()) forms.insert(ResolveForm(mod, form));
+	else for (const auto& i : form) forms.insert(ResolveForm(mod, i));
+	return forms;
+}
+
+struct MockItem
+{
+	UInt32							index = 0;
+	UInt32							tagID = 0;
+	std::string						tag;
+	SInt32							priority = 0;
+	std::string						file;
+	UInt32							fileIndex = 0;
+
+	std::unordered_set<UInt32>		formIDs;
+	std::unordered_set<UInt8>		formType;
+	std::optional<bool>				questItem, miscComponent, miscProduct;
+
+	MockItem(const nlohmann::json& elem)
+	{
+		tag = elem["tag"].get<std::string>();
+		priority = elem["priority"].get<SInt32>();
+		if (elem.contains("formType"))		formType = GetSet<UInt8>(elem["formType"]);
+		if (elem.contains("questItem"))		questItem = elem["questItem"].get<UInt8>();
+		if (elem.contains("miscComponent"))	miscComponent = elem["miscComponent"].get<UInt8>();
+		if (elem.contains("miscProduct"))	miscProduct = elem["miscProduct"].get<UInt8>();
+		// the mock has no form lists, a list or repair list is matched as the form it names
+		if (elem.contains("mod") && elem.contains("form")) formIDs = GetForms(elem["mod"], elem["form"]);
+	}
+	virtual ~MockItem() = default;
+
+	virtual bool Satisfies(const MockForm* form) const
+	{
+		if (!formIDs.empty() && !formIDs.contains(form->refID)) return false;
+		if (!formType.empty() && !formType.contains(form->typeID)) return false;
+		if (questItem.has_value() && questItem.value() != form->questItem) return false;
+		if (miscComponent.has_value() && miscComponent.value() != form->component) return false;
+		if (miscProduct.has_value() && miscProduct.value() != form->product) return false;
+		return true;
+	}
+};
+
+struct MockWeaponRule : MockItem
+{
+	std::unordered_set<UInt32>	skill, type, handgrip, attackAnim, reloadAnim, soundLevel, ammoIDs;
+	std::optional<bool>			isAutomatic, hasScope, ignoresDTDR;
+	std::optional<UInt32>		clipRoundsMin, numProjectilesMin;
+
+	MockWeaponRule(const nlohmann::json& elem) : MockItem(elem)
+	{
+		if (elem.contains("weaponSkill"))			skill = GetSet<UInt32>(elem["weaponSkill"]);
+		if (elem.contains("weaponHandgrip"))		handgrip = GetSet<UInt32>(elem["weaponHandgrip"]);
+		if (elem.contains("weaponAttackAnim"))		attackAnim = GetSet<UInt32>(elem["weaponAttackAnim"]);
+		if (elem.contains("weaponReloadAnim"))		reloadAnim = GetSet<UInt32>(elem["weaponReloadAnim"]);
+		if (elem.contains("weaponIsAutomatic"))		isAutomatic = elem["weaponIsAutomatic"].get<UInt8>();
+		if (elem.contains("weaponHasScope"))		hasScope = elem["weaponHasScope"].get<UInt8>();
+		if (elem.contains("weaponIgnoresDTDR"))		ignoresDTDR = elem["weaponIgnoresDTDR"].get<UInt8>();
+		if (elem.contains("weaponClipRounds"))		clipRoundsMin = elem["weaponClipRounds"].get<UInt32>();
+		if (elem.contains("weaponNumProjectiles"))	numProjectilesMin = elem["weaponNumProjectiles"].get<UInt32>();
+		if (elem.contains("weaponSoundLevel"))		soundLevel = GetSet<UInt32>(elem["weaponSoundLevel"]);
+		if (elem.contains("ammoMod") && elem.contains("ammoForm")) ammoIDs = GetForms(elem["ammoMod"], elem["ammoForm"]);
+		if (elem.contains("weaponType"))			type = GetSet<UInt32>(elem["weaponType"]);
+	}
+
+	bool Satisfies(const MockForm* form) const override
+	{
+		if (!MockItem::Satisfies(form)) return false;
+		if (form->typeID != kFormType_TESObjectWEAP) return true;
+
+		const auto weapon = static_cast<const MockWeapon*>(form);
+		if (!skill.empty() && !skill.contains(weapon->skill)) return false;
+		if (!type.empty() && !type.contains(weapon->type)) return false;
+		if (!handgrip.empty() && !handgrip.contains(weapon->handgrip)) return false;
+		if (!attackAnim.empty() && !attackAnim.contains(weapon->attackAnim)) return false;
+		if (!reloadAnim.empty() && !reloadAnim.contains(weapon->reloadAnim)) return false;
+		if (isAutomatic.has_value() && isAutomatic.value() != weapon->automatic) return false;
+		if (hasScope.has_value() && hasScope.value() != weapon->scope) return false;
+		if (ignoresDTDR.has_value() && ignoresDTDR.value() != weapon->ignoresDTDR) return false;
+		if (clipRoundsMin.has_value() && clipRoundsMin.value() > weapon->clipRounds) return false;
+		if (numProjectilesMin.has_value() && numProjectilesMin.value() > weapon->numProjectiles) return false;
+		if (!soundLevel.empty() && !soundLevel.contains(weapon->soundLevel)) return false;
+		if (!ammoIDs.empty() && !ammoIDs.contains(weapon->ammo)) return false;
+		return true;
+	}
+};
+
+const std::unordered_map<std::string_view, UInt32> kArmorSlots
+{
+	{ "armorHead", 1 << 0x0 }, { "armorHair", 1 << 0x1 }, { "armorUpperBody", 1 << 0x2 }, { "armorLeftHand", 1 << 0x3 },
+	{ "armorRightHand", 1 << 0x4 }, { "armorWeapon", 1 << 0x5 }, { "armorPipBoy", 1 << 0x6 }, { "armorBackpack", 1 << 0x7 },
+	{ "armorNecklace", 1 << 0x8 }, { "armorHeadband", 1 << 0x9 }, { "armorHat", 1 << 0xA }, { "armorEyeglasses", 1 << 0xB },
+	{ "armorNosering", 1 << 0xC }, { "armorEarrings", 1 << 0xD }, { "armorMask", 1 << 0xE }, { "armorChoker", 1 << 0xF },
+	{ "armorMouthObject", 1 << 0x10 }, { "armorBodyAddon1", 1 << 0x11 }, { "armorBodyAddon2", 1 << 0x12 }, { "armorBodyAddon3", 1 << 0x13 },
+};
+
+struct MockArmorRule : MockItem
+{
+	UInt32	slotsMaskWL = 0, slotsMaskBL = 0, armorClass = 0, powerArmor = 0, hasBackpack = 0, dr = 0;
+	float	dt = 0;
+
+	MockArmorRule(const nlohmann::json& elem) : MockItem(elem)
+	{
+		for (const auto& [key, value] : elem.items())
+			if (const auto iter = kArmorSlots.find(key); iter != kArmorSlots.end())
+				(value.get<SInt8>() == 1 ? slotsMaskWL : slotsMaskBL) |= iter->second;
+		if (elem.contains("armorClass"))		armorClass = elem["armorClass"].get<UInt16>();
+		if (elem.contains("armorPower"))		powerArmor = elem["armorPower"].get<SInt8>();
+		if (elem.contains("armorHasBackpack"))	hasBackpack = elem["armorHasBackpack"].get<SInt8>();
+		if (elem.contains("armorDT"))			dt = elem["armorDT"].get<float>();
+		if (elem.contains("armorDR"))			dr = elem["armorDR"].get<UInt16>();
+	}
+
+	bool Satisfies(const MockForm* form) const override
+	{
+		if (!MockItem::Satisfies(form)) return false;
+		if (form->typeID != kFormType_TESObjectARMO) return true;
+
+		const auto armor = static_cast<const MockArmor*>(form);
+		if (slotsMaskWL && (slotsMaskWL & armor->slots) != slotsMaskWL) return false;
+		if (slotsMaskBL && (slotsMaskBL & armor->slots) != 0) return false;
+		if (armorClass && armorClass != armor->armorClass) return false;
+		if (powerArmor && powerArmor != armor->power) return false;
+		if (hasBackpack && hasBackpack != armor->backpack) return false;
+		if (dt && dt > armor->dt) return false;
+		if (dr && dr > armor->dr) return false;
+		return true;
+	}
+};
+
+struct MockAidRule : MockItem
+{
+	UInt32	restoresAV = 0, damagesAV = 0;
+	bool	isAddictive = false, isFood = false, isWater = false, isPoisonous = false, isMedicine = false;
+
+	MockAidRule(const nlohmann::json& elem) : MockItem(elem)
+	{
+		if (elem.contains("aidRestoresAV"))		restoresAV = elem["aidRestoresAV"].get<UInt8>();
+		if (elem.contains("aidDamagesAV"))		damagesAV = elem["aidDamagesAV"].get<UInt8>();
+		if (elem.contains("aidIsAddictive"))	isAddictive = elem["aidIsAddictive"].get<UInt8>();
+		if (elem.contains("aidIsFood"))			isFood = elem["aidIsFood"].get<UInt8>();
+		if (elem.contains("aidIsWater"))		isWater = elem["aidIsWater"].get<UInt8>();
+		if (elem.contains("aidIsMedicine"))		isMedicine = elem["aidIsMedicine"].get<UInt8>();
+		if (elem.contains("aidIsPoisonous"))	isPoisonous = elem["aidIsPoisonous"].get<UInt8>();
+	}
+
+	bool Satisfies(const MockForm* form) const override
+	{
+		if (!MockItem::Satisfies(form)) return false;
+		if (form->typeID != kFormType_AlchemyItem) return true;
+
+		const auto aid = static_cast<const MockAid*>(form);
+		if (restoresAV && restoresAV != aid->restores) return false;
+		if (damagesAV && damagesAV != aid->damages) return false;
+		if (isAddictive && !aid->addictive) return false;
+		if (isFood && !aid->food) return false;
+		if (isWater && !aid->water) return false;
+		if (isPoisonous && !aid->poison) return false;
+		if (isMedicine && !aid->medicine) return false;
+		return true;
+	}
+};
+
+std::vector<std::unique_ptr<MockItem>> g_Items;
+
+// the item sections of the rule files, built the way ApplyJSON picks the rule class, then ordered and tagged as in Init
+void LoadRules(const std::filesystem::path& dir)
+{
+	for (const auto file : kRuleFiles)
+	{
+		std::ifstream stream(dir / file, std::ios::binary);
+		const std::string buffer{ std::istreambuf_iterator(stream), std::istreambuf_iterator<char>() };
+		const auto j = nlohmann::json::parse(buffer, nullptr, true, true);
+		const auto& items = j.contains("items") ? j["items"] : j["tags"];
+
+		UInt32 index = 0;
+		for (const auto& elem : items)
+		{
+			const auto formType = elem.contains("formType") ? GetSet<UInt8>(elem["formType"]) : std::unordered_set<UInt8>();
+			std::unique_ptr<MockItem> item;
+			if (formType.contains(kFormType_TESObjectWEAP))			item = std::make_unique<MockWeaponRule>(elem);
+			else if (formType.contains(kFormType_TESObjectARMO))	item = std::make_unique<MockArmorRule>(elem);
+			else if (formType.contains(kFormType_AlchemyItem))		item = std::make_unique<MockAidRule>(elem);
+			else													item = std::make_unique<MockItem>(elem);
+			item->file = file;
+			item->fileIndex = index++;
+			g_Items.push_back(std::move(item));
+		}
+	}
+
+	std::ranges::sort(g_Items, [](const std::unique_ptr<MockItem>& lhs, const std::unique_ptr<MockItem>& rhs)
+	{
+		if (lhs->priority != rhs->priority) return lhs->priority > rhs->priority;
+		if (lhs->file != rhs->file) return lhs->file < rhs->file;
+		return lhs->fileIndex < rhs->fileIndex;
+	});
+
+	std::map<std::string, UInt32> tagIDs;
+	for (const auto& item : g_Items) tagIDs.emplace(item->tag, 0);
+	UInt32 tagID = 0;
+	for (auto& [tag, id] : tagIDs) id = tagID++;
+	for (const auto& item : g_Items) item->tagID = tagIDs[item->tag];
+}
+
+std::mt19937 g_Random(0x5EED);
+
+template <typename T> T Pick(const std::vector<T>& values) { return values[g_Random() % values.size()]; }
+
+// forms every rule file names, then random forms of the types the rules ask for, with the values the conditions test
+std::vector<std::unique_ptr<MockForm>> MakeForms(const UInt32 count)
+{
+	std::vector<UInt32> named;
+	for (const auto& item : g_Items) named.insert(named.end(), item->formIDs.begin(), item->formIDs.end());
+	std::ranges::sort(named);
+	named.erase(std::unique(named.begin(), named.end()), named.end());
+
+	const std::vector<UInt8> types = { kFormType_TESObjectWEAP, kFormType_TESObjectWEAP, kFormType_TESObjectARMO, kFormType_TESObjectARMO,
+		kFormType_AlchemyItem, kFormType_AlchemyItem, 0x19, 0x1F, 0x1F, 0x29, 0x2E, 0x31, 0x67, 0x6C, 0x73, 0x74 };
+	const std::vector<std::string> words = { "10mm", "Pistol", "Rifle", "Armor", "Leather", "Stimpak", "Nuka-Cola", "Bobby", "Pin", "Combat", "Knife", "Scrap" };
+
+	std::vector<std::unique_ptr<MockForm>> forms;
+	for (UInt32 i = 0; i < count; i++)
+	{
+		const auto refID = i < named.size() ? named[i] : 0x7F000000 + i;
+		const auto typeID = Pick(types);
+
+		std::unique_ptr<MockForm> form;
+		if (typeID == kFormType_TESObjectWEAP)
+		{
+			auto weapon = std::make_unique<MockWeapon>();
+			weapon->skill = Pick<UInt32>({ 32, 33, 34, 35, 38, 41, 45 });
+			weapon->type = g_Random() % 14;
+			weapon->handgrip = g_Random() % 4;
+			weapon->attackAnim = Pick<UInt32>({ 0, 10, 11, 255 });
+			weapon->clipRounds = g_Random() % 40;
+			weapon->numProjectiles = g_Random() % 8 ? 1 : 4 + g_Random() % 8;
+			weapon->soundLevel = g_Random() % 3;
+			weapon->ammo = g_Random() % 16 ? 0 : ResolveForm("FalloutNV.esm", "166F63");
+			weapon->automatic = g_Random() % 4 == 0;
+			weapon->scope = g_Random() % 6 == 0;
+			weapon->ignoresDTDR = g_Random() % 20 == 0;
+			form = std::move(weapon);
+		}
+		else if (typeID == kFormType_TESObjectARMO)
+		{
+			auto armor = std::make_unique<MockArmor>();
+			armor->slots = 1u << (g_Random() % 20) | (g_Random() % 3 ? 0 : 1u << (g_Random() % 20));
+			armor->armorClass = g_Random() % 4;
+			armor->power = g_Random() % 10 == 0;
+			armor->backpack = g_Random() % 10 == 0;
+			armor->dt = static_cast<float>(g_Random() % 30);
+			armor->dr = g_Random() % 30;
+			form = std::move(armor);
+		}
+		else if (typeID == kFormType_AlchemyItem)
+		{
+			auto aid = std::make_unique<MockAid>();
+			aid->restores = Pick<UInt32>({ 0, 16, 20, 54 });
+			aid->damages = Pick<UInt32>({ 0, 0, 54 });
+			aid->addictive = g_Random() % 5 == 0;
+			aid->food = g_Random() % 2 == 0;
+			aid->water = g_Random() % 8 == 0;
+			aid->poison = g_Random() % 12 == 0;
+			aid->medicine = g_Random() % 3 == 0;
+			form = std::move(aid);
+		}
+		else form = std::make_unique<MockForm>();
+
+		form->refID = refID;
+		form->typeID = typeID;
+		form->questItem = g_Random() % 50 == 0;
+		form->component = g_Random() % 10 == 0;
+		form->product = g_Random() % 20 == 0;
+		form->name = Pick(words) + " " + Pick(words);
+		forms.push_back(std::move(form));
+	}
+	return forms;
+}
+
+MockItem* FindScan(const MockForm* form)
+{
+	for (const auto& item : g_Items) if (item->Satisfies(form)) return item.get();
+	return nullptr;
+}
+
+ItemIndex<MockItem> g_ItemIndex;
+std::unordered_map<const MockForm*, MockItem*> g_FormToItem;
+
+// Item::Get, cached matches first, then the index
+MockItem* Get(const MockForm* form)
+{
+	if (const auto iter = g_FormToItem.find(form); iter != g_FormToItem.end()) return iter->second;
+	const auto item = g_ItemIndex.Find(form->refID, form->typeID, [&](const MockItem* candidate) { return candidate->Satisfies(form); });
+	return g_FormToItem.emplace(form, item).first->second;
+}
+
+// an inventory entry, the details CompareItems only reads on a name tie
+struct MockEntry
+{
+	const MockForm*		form;
+	UInt8				weaponMod;
+	double				health;
+	bool				equipped;
+};
+
+SInt32 CompareDetails(const MockEntry& entry1, const MockEntry& entry2)
+{
+	if (entry1.weaponMod != entry2.weaponMod) return entry2.weaponMod < entry1.weaponMod ? -1 : 1;
+	if (entry1.health != entry2.health) return entry2.health < entry1.health ? -1 : 1;
+	if (entry1.equipped != entry2.equipped) return entry2.equipped < entry1.equipped ? -1 : 1;
+	if (entry1.form->refID != entry2.form->refID) return entry2.form->refID < entry1.form->refID ? -1 : 1;
+	return 0;
+}
+
+UInt32 GetTag(const MockForm* form)
+{
+	const auto item = Get(form);
+	return item ? item->tagID + 1 : 0;
+}
+
+// CompareItems: both sides looked up and named on every call
+SInt32 CompareItems(const MockEntry& entry1, const MockEntry& entry2)
+{
+	const auto tag1 = GetTag(entry1.form), tag2 = GetTag(entry2.form);
+	if (tag1 != tag2) return tag1 < tag2 ? -1 : 1;
+	if (const auto cmp = strcmp(entry1.form->name.c_str(), entry2.form->name.c_str())) return cmp < 0 ? -1 : 1;
+	return CompareDetails(entry1, entry2);
+}
+
+// Sorting::Sort: a key per entry, radix sorted on tag and name prefix, the comparison only inside runs
+std::vector<UInt32> SortKeyed(const std::vector<MockEntry>& entries)
+{
+	std::vector<std::pair<UInt32, const char*>> keys;
+	keys.reserve(entries.size());
+	for (const auto& entry : entries) keys.emplace_back(GetTag(entry.form), entry.form->name.c_str());
+
+	std::vector<std::pair<UInt64, UInt32>> packed;
+	packed.reserve(entries.size());
+	for (UInt32 i = 0; i < keys.size(); i++) packed.emplace_back(Sorting::PackSortKey(keys[i].first, keys[i].second), i);
+
+	Sorting::RadixSort(packed);
+	Sorting::SortRuns(packed, [&](const UInt32 lhs, const UInt32 rhs)
+	{
+		if (const auto cmp = strcmp(keys[lhs].second, keys[rhs].second)) return cmp < 0;
+		return CompareDetails(entries[lhs], entries[rhs]) < 0;
+	});
+
+	std::vector<UInt32> order;
+	order.reserve(entries.size());
+	for (const auto& [key, index] : packed) order.push_back(index);
+	return order;
+}
+
+void Benchmark(const UInt32 count)
+{
+	const auto forms = MakeForms(count);
+
+	g_FormToItem.clear();
+	auto then = Clock::now();
+	std::vector<MockItem*> scanned;
+	scanned.reserve(forms.size());
+	for (const auto& form : forms) scanned.push_back(FindScan(form.get()));
+	const auto scan = Micro(then);
+
+	then = Clock::now();
+	std::vector<MockItem*> indexed;
+	indexed.reserve(forms.size());
+	for (const auto& form : forms) indexed.push_back(Get(form.get()));
+	const auto index = Micro(then);
+
+	then = Clock::now();
+	UInt32 matched = 0;
+	for (const auto& form : forms) matched += Get(form.get()) != nullptr;
+	const auto cached = Micro(then);
+
+	CHECK(indexed == scanned);
+
+	std::vector<MockEntry> entries;
+	entries.reserve(forms.size());
+	for (const auto& form : forms) entries.push_back({ form.get(), static_cast<UInt8>(g_Random() % 2), static_cast<double>(g_Random() % 5) / 4, g_Random() % 8 == 0 });
+
+	then = Clock::now();
+	std::vector<UInt32> compared(entries.size());
+	for (UInt32 i = 0; i < compared.size(); i++) compared[i] = i;
+	std::sort(compared.begin(), compared.end(), [&](const UInt32 lhs, const UInt32 rhs) { return CompareItems(entries[lhs], entries[rhs]) < 0; });
+	const auto comparator = Micro(then);
+
+	then = Clock::now();
+	const auto keyed = SortKeyed(entries);
+	const auto sort = Micro(then);
+
+	CHECK(keyed == compared);
+
+	std::printf("%u forms, %u matched: rule scan %lld us, index %lld us, cached %lld us; CompareItems sort %lld us, keyed sort %lld us\n",
+		count, matched, scan, index, cached, comparator, sort);
+}
+
+int main()
+{
+	const auto then = Clock::now();
+	LoadRules(YUI_RULE_DIR);
+	std::printf("%zu item rules from %zu files, %zu mods, loaded in %lld us\n", g_Items.size(), std::size(kRuleFiles), g_ModIndices.size(), Micro(then));
+	CHECK(g_Items.size() > 400);
+
+	g_ItemIndex.Build(g_Items);
+	for (const UInt32 count : { 10000u, 100000u }) Benchmark(count);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,15 @@
+#pragma once
+// declarations of the Unicode reference converter SimpleIni includes outside Windows
+// the tests only use CSimpleIniA, which never instantiates the wide converter, so nothing here is defined or linked
+
+typedef unsigned int	UTF32;
+typedef unsigned short	UTF16;
+typedef unsigned char	UTF8;
+
+typedef enum { conversionOK, sourceExhausted, targetExhausted, sourceIllegal } ConversionResult;
+typedef enum { strictConversion = 0, lenientConversion } ConversionFlags;
+
+ConversionResult ConvertUTF8toUTF16(const UTF8** sourceStart, const UTF8* sourceEnd, UTF16** targetStart, UTF16* targetEnd, ConversionFlags flags);
+ConversionResult ConvertUTF16toUTF8(const UTF16** sourceStart, const UTF16* sourceEnd, UTF8** targetStart, UTF8* targetEnd, ConversionFlags flags);
+ConversionResult ConvertUTF8toUTF32(const UTF8** sourceStart, const UTF8* sourceEnd, UTF32** targetStart, UTF32* targetEnd, ConversionFlags flags);
+ConversionResult ConvertUTF32toUTF8(const UTF32** sourceStart, const UTF32* sourceEnd, UTF8** targetStart, UTF8* targetEnd, ConversionFlags flags);
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+// the types the plugin gets from its prefix header
+using UInt8 = std::uint8_t;
+using UInt16 = std::uint16_t;
+using UInt32 = std::uint32_t;
+using UInt64 = std::uint64_t;
+using SInt8 = std::int8_t;
+using SInt32 = std::int32_t;
+
+// the bundled SimpleIni marks a few members with the MSVC spelling
+#ifndef _MSC_VER
+#define _declspec(x)
+#endif
+
+inline UInt32 g_Failures = 0;
+
+#define CHECK(condition) \
+	do { if (!(condition)) { std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); g_Failures++; } } while (0)
+
+#define TEST_RESULT() (g_Failures ? std::printf("%u checks failed\n", g_Failures), 1 : 0)
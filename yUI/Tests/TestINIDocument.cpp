@@ -0,0 +1,129 @@
+#include "Test.h"
+#include "ConfigurationMenu/ConfigurationMenuINIDocument.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+const char* kSource =
+	"; comment kept through saves\n"
+	"[General]\n"
+	"bEnabled = 1\n"
+	"fScale=0.5\n"
+	"\n"
+	"[Sorting]\n"
+	"sName = default\n"
+	"iCount = 3\n";
+
+const std::vector<std::tuple<const char*, const char*, const char*>> kWrites =
+{
+	{ "General", "bEnabled", "0" },
+	{ "Sorting", "iCount", "7" },
+	{ "General", "bEnabled", "1" },
+	{ "Sorting", "sName", "custom" },
+	{ "Added", "iNew", "42" },
+	{ "Sorting", "iCount", "8" },
+};
+
+std::string ReadFile(const fs::path& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return { std::istreambuf_iterator(file), std::istreambuf_iterator<char>() };
+}
+
+void WriteFile(const fs::path& path, const std::string& contents)
+{
+	std::ofstream(path, std::ios::binary | std::ios::trunc) << contents;
+}
+
+// saves the way the plugin's wide path overload does, which writes whether or not anything changed
+void SaveLegacy(const CSimpleIniA& ini, const fs::path& path)
+{
+	const auto file = std::fopen(path.string().c_str(), "wb");
+	ini.SaveFile(file, false);
+	std::fclose(file);
+}
+
+// what the menu did before documents were kept: load, change and save the whole file on every read and write
+std::string WriteLegacy(const fs::path& path)
+{
+	WriteFile(path, kSource);
+	{
+		CSimpleIniA ini;
+		ini.SetUnicode();
+		ini.LoadFile(path.c_str());
+		SaveLegacy(ini, path);
+	}
+	for (const auto& [section, key, value] : kWrites)
+	{
+		CSimpleIniA ini;
+		ini.SetUnicode();
+		ini.LoadFile(path.c_str());
+		ini.SetValue(section, key, value);
+		SaveLegacy(ini, path);
+	}
+	return ReadFile(path);
+}
+
+int main()
+{
+	const auto dir = fs::temp_directory_path() / "yUITestINIDocument";
+	fs::remove_all(dir);
+	fs::create_directories(dir);
+
+	const auto expected = WriteLegacy(dir / "legacy.ini");
+
+	const auto path = dir / "document.ini";
+	WriteFile(path, kSource);
+	const auto before = fs::last_write_time(path);
+
+	INIDocument document;
+	document.ini.SetUnicode();
+	CHECK(document.ini.LoadFile(path.c_str()) >= 0);
+	document.dirty = true;
+	for (const auto& [section, key, value] : kWrites)
+	{
+		document.ini.SetValue(section, key, value);
+		document.dirty = true;
+	}
+
+	// nothing reaches the disk until the flush, and the flush writes it once
+	CHECK(ReadFile(path) == kSource);
+	CHECK(fs::last_write_time(path) == before);
+
+	std::string error;
+	CHECK(FlushINIDocument(path, document, error));
+	CHECK(error.empty());
+	CHECK(!document.dirty);
+	CHECK(ReadFile(path) == expected);
+	CHECK(!fs::exists(dir / "document.ini.tmp"));
+
+	// a clean document is not written again
+	const auto stamp = fs::file_time_type::clock::now() - std::chrono::hours(1);
+	fs::last_write_time(path, stamp);
+	error.clear();
+	CHECK(!FlushINIDocument(path, document, error));
+	CHECK(error.empty());
+	CHECK(fs::last_write_time(path) == stamp);
+
+	// a failed replace leaves the document dirty so the next flush tries again
+	const auto blocked = dir / "blocked.ini";
+	fs::create_directories(blocked / "occupied");
+	document.dirty = true;
+	CHECK(!FlushINIDocument(blocked, document, error));
+	CHECK(!error.empty());
+	CHECK(document.dirty);
+
+	fs::remove_all(blocked);
+	error.clear();
+	CHECK(FlushINIDocument(blocked, document, error));
+	CHECK(!document.dirty);
+	CHECK(ReadFile(blocked) == expected);
+
+	fs::remove_all(dir);
+	return TEST_RESULT();
+}
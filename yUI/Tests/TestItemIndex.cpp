@@ -0,0 +1,134 @@
+#include "Test.h"
+#include "SortingIcons/SortingIconsItemIndex.h"
+
+#include <chrono>
+#include <random>
+#include <unordered_set>
+
+using SortingIcons::ItemIndex;
+
+// a rule as the index sees it, plus a stand-in for the conditions the game checks beyond formIDs and formType
+struct MockRule
+{
+	UInt32						index = 0;
+	std::unordered_set<UInt32>	formIDs;
+	std::unordered_set<UInt8>	formType;
+	UInt32						modulus = 1;	// only forms whose refID is a multiple of it pass the other conditions
+
+	bool Satisfies(const UInt32 refID, const UInt8 typeID) const
+	{
+		if (!formIDs.empty() && !formIDs.contains(refID)) return false;
+		if (!formType.empty() && !formType.contains(typeID)) return false;
+		return refID % modulus == 0;
+	}
+};
+
+std::mt19937 g_Random(0x5EED);
+
+constexpr UInt32 kForms = 400;
+constexpr UInt8 kTypes = 6;
+
+UInt8 TypeOf(const UInt32 refID) { return refID % kTypes; }
+
+// rules naming forms, rules with formType, rules with both, and catch-all rules with neither, in random order
+std::vector<std::unique_ptr<MockRule>> MakeRules(const UInt32 count)
+{
+	std::vector<std::unique_ptr<MockRule>> rules;
+	for (UInt32 i = 0; i < count; i++)
+	{
+		auto rule = std::make_unique<MockRule>();
+		const auto shape = g_Random() % 4;
+		if (shape == 0 || shape == 2) for (UInt32 j = g_Random() % 8 + 1; j; j--) rule->formIDs.insert(g_Random() % kForms);
+		if (shape == 1 || shape == 2) for (UInt32 j = g_Random() % 2 + 1; j; j--) rule->formType.insert(g_Random() % kTypes);
+		rule->modulus = g_Random() % 3 + 1;
+		rules.push_back(std::move(rule));
+	}
+	return rules;
+}
+
+MockRule* FindScan(const std::vector<std::unique_ptr<MockRule>>& rules, const UInt32 refID)
+{
+	for (const auto& rule : rules) if (rule->Satisfies(refID, TypeOf(refID))) return rule.get();
+	return nullptr;
+}
+
+void TestMatchesScan()
+{
+	for (UInt32 round = 0; round < 50; round++)
+	{
+		const auto rules = MakeRules(g_Random() % 40 + 1);
+		ItemIndex<MockRule> index;
+		index.Build(rules);
+
+		for (UInt32 refID = 0; refID < kForms; refID++)
+		{
+			// a rule with both formIDs and formType sits in one bucket only, the merge never meets it twice
+			std::unordered_set<const MockRule*> evaluated;
+			bool twice = false;
+			const auto found = index.Find(refID, TypeOf(refID), [&](const MockRule* rule)
+			{
+				twice |= !evaluated.insert(rule).second;
+				return rule->Satisfies(refID, TypeOf(refID));
+			});
+			CHECK(found == FindScan(rules, refID));
+			CHECK(!twice);
+		}
+	}
+}
+
+void TestMergeOrder()
+{
+	// a named rule with a formType between a catch-all, a typed rule and a last catch-all; 10 and 22 are of type 4, 12 and 18 of type 0
+	std::vector<std::unique_ptr<MockRule>> rules;
+	rules.push_back(std::make_unique<MockRule>(MockRule{ 0, {}, {}, 5 }));
+	rules.push_back(std::make_unique<MockRule>(MockRule{ 0, { 10, 12, 22 }, { 4 }, 1 }));
+	rules.push_back(std::make_unique<MockRule>(MockRule{ 0, {}, { 0 }, 2 }));
+	rules.push_back(std::make_unique<MockRule>(MockRule{ 0, {}, {}, 1 }));
+
+	ItemIndex<MockRule> index;
+	index.Build(rules);
+	for (UInt32 i = 0; i < rules.size(); i++) CHECK(rules[i]->index == i);
+
+	const auto find = [&](const UInt32 refID) { return index.Find(refID, TypeOf(refID), [&](const MockRule* rule) { return rule->Satisfies(refID, TypeOf(refID)); }); };
+	CHECK(find(10) == rules[0].get());		// the catch-all ahead of the named rule still wins
+	CHECK(find(22) == rules[1].get());
+	CHECK(find(12) == rules[2].get());		// named, but not of the named rule's formType
+	CHECK(find(18) == rules[2].get());
+	CHECK(find(13) == rules[3].get());
+
+	// rebuilding renumbers the rules and drops the old buckets
+	rules.erase(rules.begin());
+	index.Build(rules);
+	for (UInt32 i = 0; i < rules.size(); i++) CHECK(rules[i]->index == i);
+	CHECK(find(10) == rules[0].get());
+	CHECK(find(15) == rules[2].get());
+}
+
+void Benchmark()
+{
+	const auto rules = MakeRules(400);
+	ItemIndex<MockRule> index;
+	index.Build(rules);
+
+	UInt32 scanned = 0, indexed = 0;
+	const auto then = std::chrono::steady_clock::now();
+	for (UInt32 refID = 0; refID < kForms; refID++) scanned += FindScan(rules, refID) != nullptr;
+	const auto scan = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - then);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (UInt32 refID = 0; refID < kForms; refID++)
+		indexed += index.Find(refID, TypeOf(refID), [&](const MockRule* rule) { return rule->Satisfies(refID, TypeOf(refID)); }) != nullptr;
+	const auto lookup = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+	CHECK(scanned == indexed);
+	std::printf("%zu rules, %u forms: rule scan %lld us, index %lld us\n", rules.size(), kForms,
+		static_cast<long long>(scan.count()), static_cast<long long>(lookup.count()));
+}
+
+int main()
+{
+	TestMatchesScan();
+	TestMergeOrder();
+	Benchmark();
+	return TEST_RESULT();
+}
@@ -0,0 +1,120 @@
+#include "Test.h"
+#include "SortingIcons/SortingIconsLists.h"
+
+#include <set>
+
+using SortingIcons::Files::ListFlattener;
+
+// a form list for the mock graph, member IDs below 100 are plain forms and nested lists are held by pointer
+struct MockList
+{
+	UInt32					id;
+	std::vector<UInt32>		forms;
+	std::vector<MockList*>	lists = {};
+};
+
+struct MockTraits
+{
+	using List = MockList;
+
+	static inline UInt32 cycles = 0;
+
+	static UInt32 GetID(const MockList* list) { return list->id; }
+
+	template <typename F> static void ForEach(MockList* list, F&& visit)
+	{
+		for (const auto form : list->forms) visit(form, nullptr);
+		for (const auto nested : list->lists) visit(nested->id, nested);
+	}
+
+	static void OnCycle(const MockList*) { cycles++; }
+};
+
+std::set<UInt32> AsSet(const std::vector<UInt32>& forms) { return { forms.begin(), forms.end() }; }
+
+void TestSelfLoop()
+{
+	MockTraits::cycles = 0;
+	MockList a{ 100, { 1, 2 } };
+	a.lists = { &a };
+
+	ListFlattener<MockTraits> flattener;
+	CHECK(AsSet(flattener.Flatten(&a)) == std::set<UInt32>({ 1, 2 }));
+	CHECK(MockTraits::cycles == 1);
+	CHECK(flattener.IsFlattened(100));
+}
+
+void TestTwoListCycle()
+{
+	MockTraits::cycles = 0;
+	MockList a{ 100, { 1 } }, b{ 101, { 2 } };
+	a.lists = { &b };
+	b.lists = { &a };
+
+	ListFlattener<MockTraits> flattener;
+	CHECK(AsSet(flattener.Flatten(&a)) == std::set<UInt32>({ 1, 2 }));
+	CHECK(MockTraits::cycles == 1);
+	// B only saw part of the cycle while A was being walked, so it must not have been cached then
+	CHECK(!flattener.IsFlattened(101));
+	CHECK(AsSet(flattener.Flatten(&b)) == std::set<UInt32>({ 1, 2 }));
+}
+
+void TestDiamond()
+{
+	MockTraits::cycles = 0;
+	MockList a{ 100, { 1 } }, b{ 101, { 2 } }, c{ 102, { 3 } }, d{ 103, { 4 } };
+	a.lists = { &b, &c };
+	b.lists = { &d };
+	c.lists = { &d };
+
+	ListFlattener<MockTraits> flattener;
+	CHECK(AsSet(flattener.Flatten(&a)) == std::set<UInt32>({ 1, 2, 3, 4 }));
+	CHECK(MockTraits::cycles == 0);
+	for (const auto id : { 100, 101, 102, 103 }) CHECK(flattener.IsFlattened(id));
+	CHECK(AsSet(flattener.Flatten(&c)) == std::set<UInt32>({ 3, 4 }));
+
+	// D is walked once and reused from the cache by C
+	CHECK(flattener.Flatten(&a).size() == 5);
+}
+
+void TestCachedListInsideCycle()
+{
+	MockTraits::cycles = 0;
+	MockList a{ 100, { 1 } }, b{ 101, { 2 } }, c{ 102, { 3 } }, d{ 103, { 4 } };
+	c.lists = { &d };
+	a.lists = { &b };
+	b.lists = { &c, &a };
+
+	ListFlattener<MockTraits> flattener;
+	CHECK(AsSet(flattener.Flatten(&c)) == std::set<UInt32>({ 3, 4 }));
+	CHECK(flattener.IsFlattened(102));
+
+	// C is reached again from B while A -> B -> A is being walked, its cached members still count
+	CHECK(AsSet(flattener.Flatten(&a)) == std::set<UInt32>({ 1, 2, 3, 4 }));
+	CHECK(MockTraits::cycles == 1);
+	CHECK(!flattener.IsFlattened(101));
+	CHECK(AsSet(flattener.Flatten(&b)) == std::set<UInt32>({ 1, 2, 3, 4 }));
+	CHECK(AsSet(flattener.Flatten(&c)) == std::set<UInt32>({ 3, 4 }));
+
+	// a cycle hanging off a list in the middle of the walk is cached at the list that closes it
+	MockList x{ 200, { 10 } }, y{ 201, { 11 } }, z{ 202, { 12 } };
+	x.lists = { &y };
+	y.lists = { &z };
+	z.lists = { &y, &c };
+	CHECK(AsSet(flattener.Flatten(&x)) == std::set<UInt32>({ 10, 11, 12, 3, 4 }));
+	CHECK(flattener.IsFlattened(201));
+	CHECK(!flattener.IsFlattened(202));
+	CHECK(AsSet(flattener.Flatten(&z)) == std::set<UInt32>({ 11, 12, 3, 4 }));
+
+	flattener.Clear();
+	CHECK(!flattener.IsFlattened(100));
+}
+
+int main()
+{
+	TestSelfLoop();
+	TestTwoListCycle();
+	TestDiamond();
+	TestCachedListInsideCycle();
+	return TEST_RESULT();
+}
@@ -0,0 +1,133 @@
+#include "Test.h"
+#include "SortingIcons/SortingIconsRadix.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+
+using namespace SortingIcons::Sorting;
+
+std::mt19937_64 g_Random(0x5EED);
+
+void TestStable()
+{
+	for (const UInt32 size : { 0u, 1u, 2u, 17u, 1000u })
+	{
+		std::vector<std::pair<UInt64, UInt32>> keyed;
+		for (UInt32 i = 0; i < size; i++)
+		{
+			// few distinct values spread over every byte, so ties are common and no pass is skipped by accident
+			const UInt64 value = g_Random() % 16;
+			keyed.emplace_back(value * 0x0101010101010101ull ^ (value & 1) << 63, i);
+		}
+
+		auto expected = keyed;
+		std::stable_sort(expected.begin(), expected.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+		RadixSort(keyed);
+		CHECK(keyed == expected);
+	}
+}
+
+void TestSkippedPasses()
+{
+	// keys that differ in a single byte only, every other pass is skipped
+	for (UInt32 shift = 0; shift < 64; shift += 8)
+	{
+		std::vector<std::pair<UInt64, UInt32>> keyed;
+		for (UInt32 i = 0; i < 300; i++) keyed.emplace_back((0x1122334455667788ull & ~(0xFFull << shift)) | (g_Random() & 0xFF) << shift, i);
+
+		auto expected = keyed;
+		std::stable_sort(expected.begin(), expected.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+		RadixSort(keyed);
+		CHECK(keyed == expected);
+	}
+}
+
+struct Entry
+{
+	UInt32			tag;
+	std::string		name;
+	UInt32			detail;
+};
+
+std::vector<Entry> MakeEntries(const UInt32 count)
+{
+	// a small alphabet with a high byte and names around the packed length, so prefixes and full names both tie
+	const char alphabet[] = { 'A', 'B', 'a', ' ', '\xE9' };
+	std::vector<Entry> entries;
+	for (UInt32 i = 0; i < count; i++)
+	{
+		Entry entry{ static_cast<UInt32>(g_Random() % 5), {}, static_cast<UInt32>(g_Random() % 4) };
+		const auto length = g_Random() % 10;
+		for (UInt32 j = 0; j < length; j++) entry.name += alphabet[g_Random() % sizeof(alphabet)];
+		entries.push_back(std::move(entry));
+	}
+	return entries;
+}
+
+bool LessEntry(const Entry& lhs, const Entry& rhs)
+{
+	if (lhs.tag != rhs.tag) return lhs.tag < rhs.tag;
+	if (const auto cmp = strcmp(lhs.name.c_str(), rhs.name.c_str())) return cmp < 0;
+	return lhs.detail < rhs.detail;
+}
+
+std::vector<UInt32> SortPacked(const std::vector<Entry>& entries)
+{
+	std::vector<std::pair<UInt64, UInt32>> packed;
+	for (UInt32 i = 0; i < entries.size(); i++) packed.emplace_back(PackSortKey(entries[i].tag, entries[i].name.c_str()), i);
+
+	RadixSort(packed);
+	SortRuns(packed, [&](const UInt32 lhs, const UInt32 rhs) { return LessEntry(entries[lhs], entries[rhs]); });
+
+	std::vector<UInt32> order;
+	for (const auto& [key, index] : packed) order.push_back(index);
+	return order;
+}
+
+void TestPackedOrder()
+{
+	CHECK(PackSortKey(1, "") > PackSortKey(0, "\xFF\xFF\xFF\xFF\xFF\xFF"));
+	CHECK(PackSortKey(0, "AB") < PackSortKey(0, "ABC"));
+	CHECK(PackSortKey(0, "abcdefX") == PackSortKey(0, "abcdefY"));
+	CHECK(PackSortKey(0, "Z") < PackSortKey(0, "\xE9"));
+
+	for (UInt32 round = 0; round < 20; round++)
+	{
+		const auto entries = MakeEntries(500);
+		const auto order = SortPacked(entries);
+
+		CHECK(order.size() == entries.size());
+		for (UInt32 i = 1; i < order.size(); i++) CHECK(!LessEntry(entries[order[i]], entries[order[i - 1]]));
+	}
+}
+
+void Benchmark()
+{
+	const auto entries = MakeEntries(20000);
+
+	const auto then = std::chrono::steady_clock::now();
+	const auto order = SortPacked(entries);
+	const auto radix = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - then);
+
+	std::vector<UInt32> reference(entries.size());
+	for (UInt32 i = 0; i < reference.size(); i++) reference[i] = i;
+	const auto start = std::chrono::steady_clock::now();
+	std::sort(reference.begin(), reference.end(), [&](const UInt32 lhs, const UInt32 rhs) { return LessEntry(entries[lhs], entries[rhs]); });
+	const auto comparison = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+	std::printf("%zu entries: radix and runs %lld us, std::sort %lld us\n", entries.size(),
+		static_cast<long long>(radix.count()), static_cast<long long>(comparison.count()));
+}
+
+int main()
+{
+	TestStable();
+	TestSkippedPasses();
+	TestPackedOrder();
+	Benchmark();
+	return TEST_RESULT();
+}
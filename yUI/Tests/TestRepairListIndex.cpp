@@ -0,0 +1,131 @@
+#include "Test.h"
+#include "SortingIcons/SortingIconsLists.h"
+
+#include <array>
+#include <chrono>
+#include <random>
+
+using SortingIcons::Files::RepairListIndex;
+
+// a stand-in for the form map, weapons and armor may name a repair list, every other form type never does
+struct MockForm
+{
+	UInt32		refID;
+	UInt8		typeID;
+	UInt32		repairList;
+};
+
+constexpr UInt8 kWeapon = 0x28, kArmor = 0x18, kMisc = 0x1F;
+
+struct MockTraits
+{
+	using Form = MockForm;
+
+	static UInt32 GetID(const MockForm* form) { return form->refID; }
+	static UInt32 GetRepairListID(const MockForm* form) { return form->typeID == kWeapon || form->typeID == kArmor ? form->repairList : 0; }
+};
+
+std::mt19937 g_Random(0x5EED);
+
+std::vector<MockForm> MakeForms(const UInt32 count, const UInt32 lists)
+{
+	std::vector<MockForm> forms;
+	for (UInt32 i = 0; i < count; i++)
+	{
+		const UInt8 type = std::array{ kWeapon, kArmor, kMisc }[g_Random() % 3];
+		// a few forms name no list, misc forms carry stray values the index has to ignore
+		const UInt32 list = g_Random() % 5 ? 0x1000 + g_Random() % lists : 0;
+		forms.push_back({ 0x2000 + i, type, list });
+	}
+	return forms;
+}
+
+std::vector<const MockForm*> Pointers(const std::vector<MockForm>& forms)
+{
+	std::vector<const MockForm*> pointers;
+	for (const auto& form : forms) pointers.push_back(&form);
+	return pointers;
+}
+
+// what FlattenListRepair did before the index, one pass over every form for every rule naming a repair list
+std::vector<UInt32> FlattenScan(const std::vector<MockForm>& forms, const UInt32 list)
+{
+	std::vector<UInt32> output;
+	output.push_back(list);
+	for (const auto& form : forms)
+		if ((form.typeID == kWeapon || form.typeID == kArmor) && form.repairList && form.repairList == list) output.push_back(form.refID);
+	return output;
+}
+
+void TestMatchesScan()
+{
+	const auto forms = MakeForms(2000, 40);
+	const auto pointers = Pointers(forms);
+
+	RepairListIndex<MockTraits> index;
+	CHECK(!index.IsBuilt());
+	index.Build(pointers);
+	CHECK(index.IsBuilt());
+
+	// every list, plus IDs no form uses and a form that is not a list at all
+	for (UInt32 list = 0x1000 - 2; list < 0x1000 + 42; list++) CHECK(index.Flatten(list) == FlattenScan(forms, list));
+	CHECK(index.Flatten(0x2000) == FlattenScan(forms, 0x2000));
+}
+
+void TestBuiltFlag()
+{
+	// no form uses a repair list, the index is still built once and not walked again for every rule
+	auto forms = MakeForms(100, 1);
+	for (auto& form : forms) form.repairList = 0;
+	auto pointers = Pointers(forms);
+
+	RepairListIndex<MockTraits> index;
+	index.Build(pointers);
+	CHECK(index.IsBuilt());
+	CHECK(index.Flatten(0x1000) == std::vector<UInt32>{ 0x1000 });
+
+	// forms added after the build are only seen once the index is cleared, which the loader does after every load
+	forms.push_back({ 0x9000, kWeapon, 0x1000 });
+	pointers = Pointers(forms);
+	index.Build(pointers);
+	CHECK(index.Flatten(0x1000) == std::vector<UInt32>{ 0x1000 });
+
+	index.Clear();
+	CHECK(!index.IsBuilt());
+	index.Build(pointers);
+	CHECK(index.Flatten(0x1000) == FlattenScan(forms, 0x1000));
+}
+
+void Benchmark()
+{
+	const auto forms = MakeForms(100000, 60);
+	const auto pointers = Pointers(forms);
+	constexpr UInt32 rules = 25;
+
+	const auto then = std::chrono::steady_clock::now();
+	UInt32 scanned = 0;
+	for (UInt32 i = 0; i < rules; i++) scanned += FlattenScan(forms, 0x1000 + i).size();
+	const auto scan = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - then);
+
+	const auto start = std::chrono::steady_clock::now();
+	RepairListIndex<MockTraits> index;
+	UInt32 indexed = 0;
+	for (UInt32 i = 0; i < rules; i++)
+	{
+		index.Build(pointers);
+		indexed += index.Flatten(0x1000 + i).size();
+	}
+	const auto lookup = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+	CHECK(scanned == indexed);
+	std::printf("%zu forms, %u repair list rules: form scan per rule %lld us, index %lld us\n", forms.size(), rules,
+		static_cast<long long>(scan.count()), static_cast<long long>(lookup.count()));
+}
+
+int main()
+{
+	TestMatchesScan();
+	TestBuiltFlag();
+	Benchmark();
+	return TEST_RESULT();
+}
@@ -0,0 +1,219 @@
+#include "Test.h"
+#include "SortingIcons/SortingIconsStream.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+
+using namespace SortingIcons::Files;
+
+// live and peak heap bytes, each block carries its size in front of it
+std::size_t g_Live = 0, g_Peak = 0;
+
+void* operator new(const std::size_t size)
+{
+	const auto block = static_cast<std::size_t*>(std::malloc(size + sizeof(std::max_align_t)));
+	if (!block) throw std::bad_alloc();
+	*block = size;
+	g_Live += size;
+	g_Peak = std::max(g_Peak, g_Live);
+	return reinterpret_cast<char*>(block) + sizeof(std::max_align_t);
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (!memory) return;
+	const auto block = reinterpret_cast<std::size_t*>(static_cast<char*>(memory) - sizeof(std::max_align_t));
+	g_Live -= *block;
+	std::free(block);
+}
+
+void operator delete(void* memory, std::size_t) noexcept { operator delete(memory); }
+
+const char* const kRuleFiles[] = { "ySI.json", "taleoftwowastelands.json", "sawyer.json", "viciouswastes.json" };
+
+std::string ReadFile(const std::filesystem::path& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return { std::istreambuf_iterator(file), std::istreambuf_iterator<char>() };
+}
+
+// collects what the stream hands over, or only counts and copies it the way the loader builds a rule from an element
+struct Collector
+{
+	bool							keep = true;
+	UInt32							stopAfter = UINT32_MAX;
+	std::vector<std::string>		arrays;
+	nlohmann::json					elements = nlohmann::json::object();
+	nlohmann::json					values = nlohmann::json::object();
+	UInt32							count = 0;
+
+	void Array(const std::string& key)
+	{
+		arrays.push_back(key);
+		if (keep) elements[key] = nlohmann::json::array();
+	}
+
+	bool Element(const std::string& key, nlohmann::json&& element)
+	{
+		count++;
+		if (keep) elements[key].push_back(std::move(element));
+		else nlohmann::json built(std::move(element));
+		return count < stopAfter;
+	}
+
+	void Value(const std::string& key, nlohmann::json&& value) { if (keep) values[key] = std::move(value); }
+};
+
+// the document split the same way, top-level arrays to elements and everything else to values
+std::pair<nlohmann::json, nlohmann::json> Split(const nlohmann::json& document)
+{
+	auto elements = nlohmann::json::object(), values = nlohmann::json::object();
+	for (const auto& [key, value] : document.items()) (value.is_array() ? elements : values)[key] = value;
+	return { elements, values };
+}
+
+template <typename Input> bool Stream(Collector& collector, Input&& input, const nlohmann::json::input_format_t format, std::string& error)
+{
+	RuleStream stream(collector);
+	const auto parsed = nlohmann::json::sax_parse(std::forward<Input>(input), &stream, format, true, true);
+	error = stream.error;
+	return parsed;
+}
+
+std::vector<UInt8> ToMsgPack(const std::string& text, std::string& error)
+{
+	std::vector<UInt8> bytes;
+	MsgPackWriter writer(bytes);
+	if (!nlohmann::json::sax_parse(text, &writer, nlohmann::json::input_format_t::json, true, true)) error = writer.error;
+	return bytes;
+}
+
+void TestRuleFiles()
+{
+	for (const auto file : kRuleFiles)
+	{
+		const auto text = ReadFile(std::filesystem::path(YUI_RULE_DIR) / file);
+		const auto document = nlohmann::json::parse(text, nullptr, true, true);
+		const auto [elements, values] = Split(document);
+
+		std::string error;
+		Collector fromText;
+		CHECK(Stream(fromText, text, nlohmann::json::input_format_t::json, error));
+		CHECK(fromText.elements == elements);
+		CHECK(fromText.values == values);
+
+		// text written out as MessagePack by the writer, and a cache entry written from a document before streaming
+		const auto bytes = ToMsgPack(text, error);
+		CHECK(error.empty());
+		CHECK(nlohmann::json::from_msgpack(bytes) == document);
+
+		for (const auto& input : { bytes, nlohmann::json::to_msgpack(document) })
+		{
+			Collector fromBytes;
+			CHECK(Stream(fromBytes, input, nlohmann::json::input_format_t::msgpack, error));
+			CHECK(fromBytes.elements == elements);
+			CHECK(fromBytes.values == values);
+		}
+	}
+}
+
+void TestShapes()
+{
+	std::string error;
+
+	// nested containers inside elements, scalars as elements, top-level objects and scalars as values
+	const std::string text = R"({ "texatlas": "a.dds", "items": [ { "tag": "x", "form": [ "1", "2" ], "sub": { "a": [ 1, { "b": null } ] } }, 3, [ -40, 1.5e3 ] ],
+		"empty": [], "nested": { "items": [ 1 ] }, "flag": true, "big": 4294967296, "small": -2147483649, "text": ")" + std::string(300, 'x') + R"(" })";
+	const auto document = nlohmann::json::parse(text);
+	const auto [elements, values] = Split(document);
+
+	Collector collector;
+	CHECK(Stream(collector, text, nlohmann::json::input_format_t::json, error));
+	CHECK(collector.elements == elements);
+	CHECK(collector.values == values);
+	CHECK(collector.arrays == std::vector<std::string>({ "items", "empty" }));
+	CHECK(nlohmann::json::from_msgpack(ToMsgPack(text, error)) == document);
+
+	// a root that is not an object hands nothing over
+	Collector array;
+	CHECK(Stream(array, std::string(R"([ { "tag": "x" }, [ 1 ] ])"), nlohmann::json::input_format_t::json, error));
+	CHECK(array.count == 0 && array.arrays.empty() && array.values.empty());
+
+	// the handler can stop the stream, a malformed file reports where it failed
+	Collector stopped;
+	stopped.stopAfter = 1;
+	CHECK(!Stream(stopped, text, nlohmann::json::input_format_t::json, error));
+	CHECK(stopped.count == 1);
+
+	Collector broken;
+	CHECK(!Stream(broken, std::string(R"({ "items": [ { "tag": "x", } ] })"), nlohmann::json::input_format_t::json, error));
+	CHECK(!error.empty());
+	error.clear();
+	ToMsgPack(R"({ "items": [ 1, )", error);
+	CHECK(!error.empty());
+}
+
+// peak heap bytes above what was live before, while reading and loading every rule file the given way
+template <typename Load> std::size_t MeasurePeak(Load load)
+{
+	const auto base = g_Live;
+	g_Peak = g_Live;
+	for (const auto file : kRuleFiles) load(ReadFile(std::filesystem::path(YUI_RULE_DIR) / file));
+	return g_Peak - base;
+}
+
+void Benchmark()
+{
+	Collector counter;
+	counter.keep = false;
+	std::string error;
+
+	// the loader before: each text parsed into a document, written to the cache from it, each element copied into a rule
+	const auto domText = MeasurePeak([&](const std::string& text)
+	{
+		const auto document = nlohmann::json::parse(text, nullptr, true, true);
+		const auto cache = nlohmann::json::to_msgpack(document);
+		for (const auto& [key, value] : document.items()) if (value.is_array()) for (const auto& element : value) nlohmann::json built(element);
+	});
+	const auto streamText = MeasurePeak([&](const std::string& text)
+	{
+		const auto cache = ToMsgPack(text, error);
+		Stream(counter, cache, nlohmann::json::input_format_t::msgpack, error);
+	});
+
+	std::vector<std::vector<UInt8>> caches;
+	for (const auto file : kRuleFiles) caches.push_back(ToMsgPack(ReadFile(std::filesystem::path(YUI_RULE_DIR) / file), error));
+	std::size_t domCache = 0, streamCache = 0;
+	for (const auto& cache : caches)
+	{
+		g_Peak = g_Live;
+		auto base = g_Live;
+		{
+			const auto document = nlohmann::json::from_msgpack(cache);
+			for (const auto& [key, value] : document.items()) if (value.is_array()) for (const auto& element : value) nlohmann::json built(element);
+		}
+		domCache = std::max(domCache, g_Peak - base);
+
+		g_Peak = g_Live;
+		base = g_Live;
+		Stream(counter, cache, nlohmann::json::input_format_t::msgpack, error);
+		streamCache = std::max(streamCache, g_Peak - base);
+	}
+
+	CHECK(streamText < domText);
+	CHECK(streamCache < domCache);
+	std::printf("peak heap, reading and loading the text files: document %zu bytes, stream %zu bytes; loading one cached file: document %zu bytes, stream %zu bytes\n",
+		domText, streamText, domCache, streamCache);
+}
+
+int main()
+{
+	TestRuleFiles();
+	TestShapes();
+	Benchmark();
+	return TEST_RESULT();
+}
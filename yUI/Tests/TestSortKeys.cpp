@@ -0,0 +1,174 @@
+#include "Test.h"
+#include "SortingIcons/SortingIconsRadix.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+
+using namespace SortingIcons::Sorting;
+
+// every heap allocation in the process, read before and after each sort
+UInt64 g_Allocations = 0;
+
+void* operator new(const std::size_t size)
+{
+	g_Allocations++;
+	if (const auto memory = std::malloc(size ? size : 1)) return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+// an inventory entry as the comparators see it, the counters stand in for Item::Get and GetTheName on the form
+struct MockEntry
+{
+	UInt32			refID;
+	UInt32			tag;		// rank of the matched rule's tag, 0 when untagged
+	std::string		name;
+	UInt8			weaponMod;
+	double			health;
+	bool			equipped;
+};
+
+struct Calls
+{
+	UInt64	comparisons	= 0;
+	UInt64	lookups		= 0;	// Item::Get
+	UInt64	names		= 0;	// GetTheName
+	UInt64	allocations	= 0;
+};
+
+Calls g_Calls;
+
+UInt32 GetTag(const MockEntry* entry) { g_Calls.lookups++; return entry->tag; }
+const char* GetName(const MockEntry* entry) { g_Calls.names++; return entry->name.c_str(); }
+
+std::mt19937 g_Random(0x5EED);
+
+// stacks of the same item in several conditions, so names tie as often as in a real inventory
+std::vector<MockEntry> MakeEntries(const UInt32 count)
+{
+	const char* const names[] = { "10mm Pistol", "10mm Round", "Stimpak", "Stimpak (Expired)", "Leather Armor", "Leather Armor, Reinforced", "Nuka-Cola", "Bobby Pin" };
+	std::vector<MockEntry> entries;
+	for (UInt32 i = 0; i < count; i++)
+	{
+		const auto kind = g_Random() % std::size(names);
+		entries.push_back({ 0x1000 + i, static_cast<UInt32>(kind % 4), std::string(names[kind]) + (g_Random() % 3 ? "" : " +"),
+			static_cast<UInt8>(g_Random() % 2), static_cast<double>(g_Random() % 5) / 4, g_Random() % 8 == 0 });
+	}
+	return entries;
+}
+
+SInt32 CompareDetails(const MockEntry* entry1, const MockEntry* entry2)
+{
+	if (entry1->weaponMod != entry2->weaponMod) return entry2->weaponMod < entry1->weaponMod ? -1 : 1;
+	if (entry1->health != entry2->health) return entry2->health < entry1->health ? -1 : 1;
+	if (entry1->equipped != entry2->equipped) return entry2->equipped < entry1->equipped ? -1 : 1;
+	if (entry1->refID != entry2->refID) return entry2->refID < entry1->refID ? -1 : 1;
+	return 0;
+}
+
+// the comparator before sort keys: both tags looked up, both names copied into strings, every comparison
+SInt32 CompareStrings(const MockEntry* entry1, const MockEntry* entry2)
+{
+	g_Calls.comparisons++;
+	if (const auto tag1 = GetTag(entry1), tag2 = GetTag(entry2); tag1 != tag2) return tag1 < tag2 ? -1 : 1;
+
+	const std::string name1 = GetName(entry1), name2 = GetName(entry2);
+	if (const auto cmp = name1.compare(name2)) return cmp < 0 ? -1 : 1;
+	return CompareDetails(entry1, entry2);
+}
+
+// CompareItems now: a key per side built on every call, so the lookups remain but nothing is allocated
+SInt32 CompareKeys(const MockEntry* entry1, const MockEntry* entry2)
+{
+	g_Calls.comparisons++;
+	const auto tag1 = GetTag(entry1), tag2 = GetTag(entry2);
+	const auto name1 = GetName(entry1), name2 = GetName(entry2);
+	if (tag1 != tag2) return tag1 < tag2 ? -1 : 1;
+	if (const auto cmp = strcmp(name1, name2)) return cmp < 0 ? -1 : 1;
+	return CompareDetails(entry1, entry2);
+}
+
+template <typename Compare> std::vector<const MockEntry*> SortEngine(const std::vector<MockEntry>& entries, Compare compare)
+{
+	std::vector<const MockEntry*> sorted;
+	for (const auto& entry : entries) sorted.push_back(&entry);
+	std::sort(sorted.begin(), sorted.end(), [&](const MockEntry* lhs, const MockEntry* rhs) { return compare(lhs, rhs) < 0; });
+	return sorted;
+}
+
+// Sorting::Sort: one key per entry, a radix pass over tag and name prefix, the full comparison only inside runs
+std::vector<const MockEntry*> SortKeyed(const std::vector<MockEntry>& entries)
+{
+	struct Key { UInt32 tag; const char* name; };
+	std::vector<Key> keys;
+	keys.reserve(entries.size());
+	for (const auto& entry : entries) keys.push_back({ GetTag(&entry), GetName(&entry) });
+
+	std::vector<std::pair<UInt64, UInt32>> packed;
+	packed.reserve(entries.size());
+	for (UInt32 i = 0; i < keys.size(); i++) packed.emplace_back(PackSortKey(keys[i].tag, keys[i].name), i);
+
+	RadixSort(packed);
+	SortRuns(packed, [&](const UInt32 lhs, const UInt32 rhs)
+	{
+		g_Calls.comparisons++;
+		if (const auto cmp = strcmp(keys[lhs].name, keys[rhs].name)) return cmp < 0;
+		return CompareDetails(&entries[lhs], &entries[rhs]) < 0;
+	});
+
+	std::vector<const MockEntry*> sorted;
+	sorted.reserve(entries.size());
+	for (const auto& [key, index] : packed) sorted.push_back(&entries[index]);
+	return sorted;
+}
+
+template <typename Sort> std::vector<const MockEntry*> Measure(const char* label, const std::vector<MockEntry>& entries, Sort sort)
+{
+	g_Calls = {};
+	const auto allocations = g_Allocations;
+	const auto then = std::chrono::steady_clock::now();
+	auto sorted = sort(entries);
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - then);
+	g_Calls.allocations = g_Allocations - allocations;
+
+	std::printf("%-22s %8llu comparisons %8llu Item::Get %8llu GetTheName %8llu allocations %7lld us\n", label,
+		static_cast<unsigned long long>(g_Calls.comparisons), static_cast<unsigned long long>(g_Calls.lookups),
+		static_cast<unsigned long long>(g_Calls.names), static_cast<unsigned long long>(g_Calls.allocations), static_cast<long long>(elapsed.count()));
+	return sorted;
+}
+
+int main()
+{
+	for (const UInt32 count : { 200u, 5000u })
+	{
+		const auto entries = MakeEntries(count);
+		std::printf("%u entries\n", count);
+
+		const auto strings = Measure("strings per comparison", entries, [](const auto& e) { return SortEngine(e, CompareStrings); });
+		const auto stringCalls = g_Calls;
+		const auto keyed = Measure("keys per comparison", entries, [](const auto& e) { return SortEngine(e, CompareKeys); });
+		const auto keyedCalls = g_Calls;
+		const auto sorted = Measure("keys per entry", entries, SortKeyed);
+		const auto sortCalls = g_Calls;
+
+		CHECK(keyed == strings);
+		CHECK(sorted == strings);
+
+		// the engine comparator still looks both sides up on every call, only the allocations are gone
+		CHECK(keyedCalls.lookups == 2 * keyedCalls.comparisons);
+		CHECK(keyedCalls.names == 2 * keyedCalls.comparisons);
+		CHECK(keyedCalls.allocations < stringCalls.allocations);
+
+		// entries yUI sorts itself are looked up once each
+		CHECK(sortCalls.lookups == count);
+		CHECK(sortCalls.names == count);
+		CHECK(sortCalls.comparisons < keyedCalls.comparisons);
+	}
+	return TEST_RESULT();
+}
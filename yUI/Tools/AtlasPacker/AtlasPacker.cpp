@@ -0,0 +1,644 @@
+// ySIAtlas - packs Sorting and Icons .dds icons into power-of-two DXT atlases
+//
+// usage: ySIAtlas <icon dir> <output dir> [--name ySI_atlas] [--max 2048] [--padding 0] [--format dxt5|dxt1]
+//
+// writes <name>0.dds, <name>1.dds, ... plus <name>.tai, the atlas index the game reads through the texatlas trait,
+// and <name>.json, which lists the UV rectangle of every icon and goes into menus\ySI so the loader assigns the atlas
+// to every category using one of the packed icons. DXT1/3/5 icons are copied block by block and keep their format,
+// uncompressed icons are encoded to --format. Icons are only ever packed with icons of the same format.
+
+#include <json.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using UInt8 = std::uint8_t;
+using UInt16 = std::uint16_t;
+using UInt32 = std::uint32_t;
+using UInt64 = std::uint64_t;
+
+namespace DDS
+{
+	constexpr UInt32 kMagic					= 0x20534444; // 'DDS '
+
+	constexpr UInt32 kFlags_Caps			= 0x1;
+	constexpr UInt32 kFlags_Height			= 0x2;
+	constexpr UInt32 kFlags_Width			= 0x4;
+	constexpr UInt32 kFlags_PixelFormat		= 0x1000;
+	constexpr UInt32 kFlags_MipMapCount		= 0x20000;
+	constexpr UInt32 kFlags_LinearSize		= 0x80000;
+
+	constexpr UInt32 kPixelFormat_AlphaPixels	= 0x1;
+	constexpr UInt32 kPixelFormat_FourCC		= 0x4;
+	constexpr UInt32 kPixelFormat_RGB			= 0x40;
+
+	constexpr UInt32 kCaps_Complex			= 0x8;
+	constexpr UInt32 kCaps_Texture			= 0x1000;
+	constexpr UInt32 kCaps_MipMap			= 0x400000;
+
+	constexpr UInt32 FourCC(const char (&code)[5]) { return code[0] | code[1] << 8 | code[2] << 16 | code[3] << 24; }
+
+	struct PixelFormat
+	{
+		UInt32	size;
+		UInt32	flags;
+		UInt32	fourCC;
+		UInt32	bitCount;
+		UInt32	redMask;
+		UInt32	greenMask;
+		UInt32	blueMask;
+		UInt32	alphaMask;
+	};
+
+	struct Header
+	{
+		UInt32		size;
+		UInt32		flags;
+		UInt32		height;
+		UInt32		width;
+		UInt32		pitchOrLinearSize;
+		UInt32		depth;
+		UInt32		mipMapCount;
+		UInt32		reserved1[11];
+		PixelFormat	pixelFormat;
+		UInt32		caps;
+		UInt32		caps2;
+		UInt32		caps3;
+		UInt32		caps4;
+		UInt32		reserved2;
+	};
+	static_assert(sizeof(Header) == 124);
+
+	// RGBA is only an input format, it is held as 8 bits per channel and always encoded before it is written
+	enum class Format { RGBA, DXT1, DXT3, DXT5 };
+
+	const char* GetName(const Format format)
+	{
+		switch (format)
+		{
+		case Format::DXT1: return "DXT1";
+		case Format::DXT3: return "DXT3";
+		case Format::DXT5: return "DXT5";
+		default: return "RGBA";
+		}
+	}
+
+	UInt32 GetBlockSize(const Format format) { return format == Format::DXT1 ? 8 : 16; }
+
+	UInt32 GetLevelSize(const Format format, const UInt32 width, const UInt32 height)
+	{
+		if (format == Format::RGBA) return width * height * 4;
+		return std::max(1u, width / 4) * std::max(1u, height / 4) * GetBlockSize(format);
+	}
+}
+
+struct Image
+{
+	std::string							filename;
+	DDS::Format							format = DDS::Format::RGBA;
+	UInt32								width = 0;
+	UInt32								height = 0;
+	std::vector<std::vector<UInt8>>		levels;
+
+	bool								packed = false;
+	UInt32								atlas = 0;
+	UInt32								x = 0;
+	UInt32								y = 0;
+
+	// every mip level has to start and end on a block boundary, so a level can be copied as whole blocks
+	UInt32 GetMaxLevels() const
+	{
+		const auto shift = std::min(std::countr_zero(width), std::countr_zero(height));
+		return std::min<UInt32>(levels.size(), shift >= 2 ? shift - 1 : 0);
+	}
+};
+
+struct Atlas
+{
+	std::string		filename;
+	DDS::Format		format = DDS::Format::DXT5;
+	UInt32			width = 0;
+	UInt32			height = 0;
+	UInt32			levels = 1;
+};
+
+namespace Encode
+{
+	using Pixel = std::array<UInt8, 4>;
+
+	UInt16 To565(const Pixel& pixel) { return (pixel[0] >> 3) << 11 | (pixel[1] >> 2) << 5 | pixel[2] >> 3; }
+
+	Pixel From565(const UInt16 color)
+	{
+		const UInt8 r = color >> 11 & 0x1F, g = color >> 5 & 0x3F, b = color & 0x1F;
+		return { static_cast<UInt8>(r << 3 | r >> 2), static_cast<UInt8>(g << 2 | g >> 4), static_cast<UInt8>(b << 3 | b >> 2), 255 };
+	}
+
+	Pixel Mix(const Pixel& a, const Pixel& b, const UInt32 weightA, const UInt32 weightB)
+	{
+		Pixel mixed{};
+		for (UInt32 i = 0; i < 3; i++) mixed[i] = (a[i] * weightA + b[i] * weightB) / (weightA + weightB);
+		mixed[3] = 255;
+		return mixed;
+	}
+
+	UInt32 Distance(const Pixel& a, const Pixel& b)
+	{
+		UInt32 distance = 0;
+		for (UInt32 i = 0; i < 3; i++) distance += (a[i] - b[i]) * (a[i] - b[i]);
+		return distance;
+	}
+
+	void Write16(UInt8* out, const UInt16 value) { out[0] = value & 0xFF; out[1] = value >> 8; }
+
+	// bounding box endpoints inset by a sixteenth, close enough for flat UI icons
+	void Color(const std::array<Pixel, 16>& pixels, UInt8* out, const bool punchThrough)
+	{
+		Pixel min{ 255, 255, 255, 255 }, max{ 0, 0, 0, 255 };
+		bool transparent = false, opaque = false;
+		for (const auto& pixel : pixels)
+		{
+			if (punchThrough && pixel[3] < 128)
+			{
+				transparent = true;
+				continue;
+			}
+			opaque = true;
+			for (UInt32 i = 0; i < 3; i++)
+			{
+				min[i] = std::min(min[i], pixel[i]);
+				max[i] = std::max(max[i], pixel[i]);
+			}
+		}
+
+		if (!opaque)
+		{
+			Write16(out, 0);
+			Write16(out + 2, 0);
+			std::memset(out + 4, 0xFF, 4);
+			return;
+		}
+
+		for (UInt32 i = 0; i < 3; i++)
+		{
+			const UInt8 inset = (max[i] - min[i]) / 16;
+			min[i] += inset;
+			max[i] -= inset;
+		}
+
+		UInt16 color0 = To565(max), color1 = To565(min);
+		// four colour blocks need color0 > color1, blocks with transparent texels need the opposite
+		if (transparent ? color0 > color1 : color0 < color1) std::swap(color0, color1);
+
+		std::array<Pixel, 4> palette{ From565(color0), From565(color1) };
+		if (transparent) palette[2] = Mix(palette[0], palette[1], 1, 1);
+		else
+		{
+			palette[2] = Mix(palette[0], palette[1], 2, 1);
+			palette[3] = Mix(palette[0], palette[1], 1, 2);
+		}
+		const UInt32 count = transparent ? 3 : color0 == color1 ? 1 : 4;
+
+		UInt32 indices = 0;
+		for (UInt32 i = 0; i < 16; i++)
+		{
+			UInt32 best = 0;
+			if (transparent && pixels[i][3] < 128) best = 3;
+			else for (UInt32 j = 1; j < count; j++)
+				if (Distance(pixels[i], palette[j]) < Distance(pixels[i], palette[best])) best = j;
+			indices |= best << i * 2;
+		}
+
+		Write16(out, color0);
+		Write16(out + 2, color1);
+		for (UInt32 i = 0; i < 4; i++) out[4 + i] = indices >> i * 8 & 0xFF;
+	}
+
+	void Alpha(const std::array<Pixel, 16>& pixels, UInt8* out)
+	{
+		UInt8 min = 255, max = 0;
+		for (const auto& pixel : pixels)
+		{
+			min = std::min(min, pixel[3]);
+			max = std::max(max, pixel[3]);
+		}
+
+		std::array<UInt8, 8> palette{ max, min };
+		for (UInt32 i = 1; i < 7; i++) palette[i + 1] = ((7 - i) * max + i * min) / 7;
+
+		UInt64 indices = 0;
+		if (max != min) for (UInt32 i = 0; i < 16; i++)
+		{
+			UInt64 best = 0;
+			for (UInt32 j = 1; j < 8; j++)
+				if (std::abs(pixels[i][3] - palette[j]) < std::abs(pixels[i][3] - palette[best])) best = j;
+			indices |= best << i * 3;
+		}
+
+		out[0] = max;
+		out[1] = min;
+		for (UInt32 i = 0; i < 6; i++) out[2 + i] = indices >> i * 8 & 0xFF;
+	}
+
+	std::vector<UInt8> Level(const std::vector<UInt8>& rgba, const UInt32 width, const UInt32 height, const DDS::Format format)
+	{
+		std::vector<UInt8> blocks(DDS::GetLevelSize(format, width, height));
+		UInt8* out = blocks.data();
+		for (UInt32 by = 0; by < height / 4; by++)
+			for (UInt32 bx = 0; bx < width / 4; bx++)
+			{
+				std::array<Pixel, 16> pixels;
+				for (UInt32 i = 0; i < 16; i++)
+					std::memcpy(pixels[i].data(), &rgba[((by * 4 + i / 4) * width + bx * 4 + i % 4) * 4], 4);
+
+				if (format == DDS::Format::DXT5)
+				{
+					Alpha(pixels, out);
+					Color(pixels, out + 8, false);
+				}
+				else Color(pixels, out, true);
+				out += DDS::GetBlockSize(format);
+			}
+		return blocks;
+	}
+}
+
+// halves a level with a box filter, each icon is filtered on its own so nothing bleeds in from its neighbours
+std::vector<UInt8> Downsample(const std::vector<UInt8>& rgba, const UInt32 width, const UInt32 height)
+{
+	std::vector<UInt8> half(width / 2 * (height / 2) * 4);
+	for (UInt32 y = 0; y < height / 2; y++)
+		for (UInt32 x = 0; x < width / 2; x++)
+			for (UInt32 c = 0; c < 4; c++)
+			{
+				const auto at = [&](const UInt32 dx, const UInt32 dy) { return rgba[((y * 2 + dy) * width + x * 2 + dx) * 4 + c]; };
+				half[(y * (width / 2) + x) * 4 + c] = (at(0, 0) + at(1, 0) + at(0, 1) + at(1, 1) + 2) / 4;
+			}
+	return half;
+}
+
+UInt8 ReadChannel(const UInt32 pixel, const UInt32 mask, const UInt8 fallback)
+{
+	if (!mask) return fallback;
+	const UInt32 value = (pixel & mask) >> std::countr_zero(mask);
+	const UInt32 maxValue = mask >> std::countr_zero(mask);
+	return static_cast<UInt8>(value * 255 / maxValue);
+}
+
+bool ReadDDS(const std::filesystem::path& path, Image& image)
+{
+	std::ifstream file(path, std::ios::binary);
+	const std::vector<UInt8> buffer{ std::istreambuf_iterator(file), std::istreambuf_iterator<char>() };
+
+	UInt32 magic = 0;
+	DDS::Header header{};
+	if (buffer.size() < sizeof(magic) + sizeof(header)) return false;
+	std::memcpy(&magic, buffer.data(), sizeof(magic));
+	std::memcpy(&header, buffer.data() + sizeof(magic), sizeof(header));
+	if (magic != DDS::kMagic || header.size != sizeof(header)) return false;
+
+	image.width = header.width;
+	image.height = header.height;
+	if (image.width < 4 || image.height < 4 || image.width % 4 || image.height % 4)
+	{
+		std::cerr << path.string() << ": " << image.width << "x" << image.height << " is not a multiple of 4\n";
+		return false;
+	}
+
+	const auto& pixelFormat = header.pixelFormat;
+	UInt32 offset = sizeof(magic) + sizeof(header);
+
+	if (pixelFormat.flags & DDS::kPixelFormat_FourCC)
+	{
+		if (pixelFormat.fourCC == DDS::FourCC("DXT1")) image.format = DDS::Format::DXT1;
+		else if (pixelFormat.fourCC == DDS::FourCC("DXT3")) image.format = DDS::Format::DXT3;
+		else if (pixelFormat.fourCC == DDS::FourCC("DXT5")) image.format = DDS::Format::DXT5;
+		else
+		{
+			std::cerr << path.string() << ": unsupported FourCC\n";
+			return false;
+		}
+
+		const UInt32 count = header.flags & DDS::kFlags_MipMapCount ? std::max(1u, header.mipMapCount) : 1;
+		for (UInt32 level = 0; level < count; level++)
+		{
+			const UInt32 width = image.width >> level, height = image.height >> level;
+			if (width < 4 || height < 4) break;
+			const UInt32 size = DDS::GetLevelSize(image.format, width, height);
+			if (offset + size > buffer.size()) break;
+			image.levels.emplace_back(buffer.begin() + offset, buffer.begin() + offset + size);
+			offset += size;
+		}
+		return !image.levels.empty();
+	}
+
+	if (!(pixelFormat.flags & DDS::kPixelFormat_RGB) || (pixelFormat.bitCount != 32 && pixelFormat.bitCount != 24))
+	{
+		std::cerr << path.string() << ": unsupported pixel format\n";
+		return false;
+	}
+
+	const UInt32 bytes = pixelFormat.bitCount / 8;
+	if (offset + image.width * image.height * bytes > buffer.size()) return false;
+
+	const UInt32 alphaMask = pixelFormat.flags & DDS::kPixelFormat_AlphaPixels ? pixelFormat.alphaMask : 0;
+	std::vector<UInt8> rgba(image.width * image.height * 4);
+	for (UInt32 i = 0; i < image.width * image.height; i++)
+	{
+		UInt32 pixel = 0;
+		std::memcpy(&pixel, buffer.data() + offset + i * bytes, bytes);
+		rgba[i * 4 + 0] = ReadChannel(pixel, pixelFormat.redMask, 0);
+		rgba[i * 4 + 1] = ReadChannel(pixel, pixelFormat.greenMask, 0);
+		rgba[i * 4 + 2] = ReadChannel(pixel, pixelFormat.blueMask, 0);
+		rgba[i * 4 + 3] = ReadChannel(pixel, alphaMask, 255);
+	}
+
+	// the source mips are ignored, they are rebuilt from the top level so every level is filtered the same way
+	image.format = DDS::Format::RGBA;
+	image.levels.emplace_back(std::move(rgba));
+	for (UInt32 width = image.width, height = image.height; width >= 8 && height >= 8; width /= 2, height /= 2)
+		image.levels.emplace_back(Downsample(image.levels.back(), width, height));
+	return true;
+}
+
+bool WriteDDS(const std::filesystem::path& path, const Atlas& atlas, const std::vector<std::vector<UInt8>>& levels)
+{
+	DDS::Header header{};
+	header.size = sizeof(header);
+	header.flags = DDS::kFlags_Caps | DDS::kFlags_Height | DDS::kFlags_Width | DDS::kFlags_PixelFormat | DDS::kFlags_LinearSize;
+	header.height = atlas.height;
+	header.width = atlas.width;
+	header.pitchOrLinearSize = levels.front().size();
+	header.mipMapCount = levels.size();
+	header.pixelFormat.size = sizeof(header.pixelFormat);
+	header.pixelFormat.flags = DDS::kPixelFormat_FourCC;
+	header.pixelFormat.fourCC = atlas.format == DDS::Format::DXT1 ? DDS::FourCC("DXT1") : atlas.format == DDS::Format::DXT3 ? DDS::FourCC("DXT3") : DDS::FourCC("DXT5");
+	header.caps = DDS::kCaps_Texture;
+	if (levels.size() > 1)
+	{
+		header.flags |= DDS::kFlags_MipMapCount;
+		header.caps |= DDS::kCaps_Complex | DDS::kCaps_MipMap;
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(&DDS::kMagic), sizeof(DDS::kMagic));
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	for (const auto& level : levels) file.write(reinterpret_cast<const char*>(level.data()), level.size());
+	return static_cast<bool>(file);
+}
+
+// copies one level of an icon into an atlas level, RGBA is copied by rows and block formats by rows of blocks
+void Blit(const Image& image, const UInt32 level, std::vector<UInt8>& target, const UInt32 targetWidth)
+{
+	const UInt32 width = image.width >> level, height = image.height >> level;
+	const UInt32 x = image.x >> level, y = image.y >> level;
+	const auto& source = image.levels[level];
+
+	if (image.format == DDS::Format::RGBA)
+	{
+		for (UInt32 row = 0; row < height; row++)
+			std::memcpy(&target[((y + row) * targetWidth + x) * 4], &source[row * width * 4], width * 4);
+		return;
+	}
+
+	const UInt32 blockSize = DDS::GetBlockSize(image.format);
+	const UInt32 rowSize = width / 4 * blockSize;
+	for (UInt32 row = 0; row < height / 4; row++)
+		std::memcpy(&target[((y / 4 + row) * (targetWidth / 4) + x / 4) * blockSize], &source[row * rowSize], rowSize);
+}
+
+UInt32 RoundUp(const UInt32 value, const UInt32 align) { return (value + align - 1) / align * align; }
+
+// shelf packing, tallest first, images that do not fit are left in place for the next atlas
+std::vector<Image*> PackShelves(std::vector<Image*>& images, const UInt32 width, const UInt32 height, const UInt32 align, const UInt32 padding)
+{
+	std::vector<Image*> placed, left;
+	UInt32 x = 0, y = 0, shelf = 0;
+	for (const auto image : images)
+	{
+		const UInt32 w = RoundUp(image->width, align), h = RoundUp(image->height, align);
+		if (x + w > width)
+		{
+			x = 0;
+			y += shelf;
+			shelf = 0;
+		}
+		if (x + w > width || y + h > height)
+		{
+			left.push_back(image);
+			continue;
+		}
+		image->x = x;
+		image->y = y;
+		x += RoundUp(image->width + padding, align);
+		shelf = std::max(shelf, RoundUp(image->height + padding, align));
+		placed.push_back(image);
+	}
+	images = std::move(left);
+	return placed;
+}
+
+// smallest power-of-two atlas that holds every remaining image, or as many as fit at the largest size
+std::vector<Image*> PackAtlas(std::vector<Image*>& images, Atlas& atlas, const UInt32 maxSize, const UInt32 align, const UInt32 padding)
+{
+	UInt64 area = 0;
+	UInt32 width = align, height = align;
+	for (const auto image : images)
+	{
+		area += static_cast<UInt64>(RoundUp(image->width + padding, align)) * RoundUp(image->height + padding, align);
+		width = std::max(width, std::bit_ceil(RoundUp(image->width, align)));
+		height = std::max(height, std::bit_ceil(RoundUp(image->height, align)));
+	}
+
+	while (true)
+	{
+		if (static_cast<UInt64>(width) * height >= area || (width >= maxSize && height >= maxSize))
+		{
+			auto attempt = images;
+			auto placed = PackShelves(attempt, width, height, align, padding);
+			if (attempt.empty() || (width >= maxSize && height >= maxSize))
+			{
+				images = std::move(attempt);
+				atlas.width = width;
+				atlas.height = height;
+				return placed;
+			}
+		}
+		if (width <= height && width < maxSize) width *= 2;
+		else height *= 2;
+	}
+}
+
+// path the game resolves textures by, relative to the textures folder
+std::string GetGamePath(const std::filesystem::path& dir)
+{
+	const auto absolute = std::filesystem::absolute(dir).lexically_normal();
+	std::vector<std::string> parts;
+	for (const auto& part : absolute) if (!part.empty() && part != absolute.root_path()) parts.push_back(part.string());
+
+	auto start = parts.size() ? parts.size() - 1 : 0;
+	for (UInt32 i = 0; i < parts.size(); i++)
+	{
+		auto lower = parts[i];
+		std::ranges::transform(lower, lower.begin(), [](const unsigned char c) { return std::tolower(c); });
+		if (lower == "textures") start = i + 1;
+	}
+
+	std::string result;
+	for (auto i = start; i < parts.size(); i++) result += (result.empty() ? "" : "\\") + parts[i];
+	return result;
+}
+
+std::string FormatUV(const double value)
+{
+	std::ostringstream stream;
+	stream << std::fixed << std::setprecision(6) << value;
+	return stream.str();
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> args(argv + 1, argv + argc);
+	std::string name = "ySI_atlas";
+	UInt32 maxSize = 2048, padding = 0;
+	DDS::Format encodeFormat = DDS::Format::DXT5;
+
+	std::vector<std::string> positional;
+	for (UInt32 i = 0; i < args.size(); i++)
+	{
+		const auto value = [&] { return i + 1 < args.size() ? args[++i] : std::string(); };
+		if (args[i] == "--name") name = value();
+		else if (args[i] == "--max") maxSize = std::bit_floor(static_cast<UInt32>(std::stoul(value())));
+		else if (args[i] == "--padding") padding = std::stoul(value());
+		else if (args[i] == "--format") encodeFormat = value() == "dxt1" ? DDS::Format::DXT1 : DDS::Format::DXT5;
+		else positional.push_back(args[i]);
+	}
+
+	if (positional.size() != 2 || name.empty() || maxSize < 4)
+	{
+		std::cerr << "usage: ySIAtlas <icon dir> <output dir> [--name ySI_atlas] [--max 2048] [--padding 0] [--format dxt5|dxt1]\n";
+		return 1;
+	}
+
+	const std::filesystem::path input = positional[0], output = positional[1];
+	std::error_code error;
+	std::filesystem::create_directories(output, error);
+
+	const auto inputPath = GetGamePath(input), outputPath = GetGamePath(output);
+
+	std::vector<std::filesystem::path> paths;
+	for (const auto& entry : std::filesystem::directory_iterator(input, error))
+	{
+		auto extension = entry.path().extension().string();
+		std::ranges::transform(extension, extension.begin(), [](const unsigned char c) { return std::tolower(c); });
+		if (entry.is_regular_file() && extension == ".dds") paths.push_back(entry.path());
+	}
+	std::ranges::sort(paths);
+
+	std::vector<Image> images;
+	images.reserve(paths.size());
+	for (const auto& path : paths)
+	{
+		Image image;
+		if (!ReadDDS(path, image)) continue;
+		if (image.width > maxSize || image.height > maxSize)
+		{
+			std::cerr << path.string() << ": larger than the atlas\n";
+			continue;
+		}
+		image.filename = (inputPath.empty() ? "" : inputPath + "\\") + path.filename().string();
+		images.push_back(std::move(image));
+	}
+
+	// block formats only mix with themselves, uncompressed icons all go into the encoded format
+	std::map<DDS::Format, std::vector<Image*>> groups;
+	for (auto& image : images) groups[image.format].push_back(&image);
+
+	std::vector<Atlas> atlases;
+	for (auto& [format, group] : groups)
+	{
+		UInt32 levels = 32;
+		for (const auto image : group) levels = std::min(levels, image->GetMaxLevels());
+		levels = std::max(levels, 1u);
+		const UInt32 align = 4u << (levels - 1);
+
+		std::ranges::stable_sort(group, [](const Image* image1, const Image* image2)
+		{
+			if (image1->height != image2->height) return image1->height > image2->height;
+			return image1->width > image2->width;
+		});
+
+		while (!group.empty())
+		{
+			Atlas atlas;
+			atlas.format = format == DDS::Format::RGBA ? encodeFormat : format;
+			atlas.levels = levels;
+			atlas.filename = name + std::to_string(atlases.size()) + ".dds";
+
+			const auto placed = PackAtlas(group, atlas, maxSize, align, padding);
+			if (placed.empty())
+			{
+				std::cerr << "could not place " << group.size() << " icons\n";
+				break;
+			}
+
+			std::vector<std::vector<UInt8>> data;
+			for (UInt32 level = 0; level < levels; level++)
+			{
+				const UInt32 width = atlas.width >> level, height = atlas.height >> level;
+				std::vector<UInt8> target(DDS::GetLevelSize(format, width, height));
+				for (const auto image : placed) Blit(*image, level, target, width);
+				data.push_back(format == DDS::Format::RGBA ? Encode::Level(target, width, height, atlas.format) : std::move(target));
+			}
+
+			for (const auto image : placed)
+			{
+				image->packed = true;
+				image->atlas = atlases.size();
+			}
+			if (!WriteDDS(output / atlas.filename, atlas, data))
+			{
+				std::cerr << "could not write " << (output / atlas.filename).string() << "\n";
+				return 1;
+			}
+
+			std::cout << atlas.filename << ": " << atlas.width << "x" << atlas.height << " " << DDS::GetName(atlas.format)
+				<< ", " << levels << " levels, " << placed.size() << " icons\n";
+			atlases.push_back(std::move(atlas));
+		}
+	}
+
+	const auto prefix = outputPath.empty() ? "" : outputPath + "\\";
+	const auto texatlas = prefix + name + ".tai";
+
+	std::ofstream tai(output / (name + ".tai"), std::ios::trunc);
+	auto json = nlohmann::ordered_json::array();
+	for (const auto& image : images) if (image.packed)
+	{
+		const auto& atlas = atlases[image.atlas];
+		const double u = static_cast<double>(image.x) / atlas.width, v = static_cast<double>(image.y) / atlas.height;
+		const double w = static_cast<double>(image.width) / atlas.width, h = static_cast<double>(image.height) / atlas.height;
+
+		tai << image.filename << "\t\t" << prefix << atlas.filename << ", " << image.atlas << ", 2D, "
+			<< FormatUV(u) << ", " << FormatUV(v) << ", " << FormatUV(0) << ", " << FormatUV(w) << ", " << FormatUV(h) << "\n";
+
+		json.push_back({ { "filename", image.filename }, { "texatlas", texatlas }, { "texture", prefix + atlas.filename }, { "uv", { u, v, w, h } } });
+	}
+
+	std::ofstream file(output / (name + ".json"), std::ios::trunc);
+	file << nlohmann::ordered_json{ { "atlas", json } }.dump(1, '\t') << "\n";
+
+	std::cout << images.size() << " icons packed into " << atlases.size() << " atlases\n";
+	return tai && file ? 0 : 1;
+}
@@ -0,0 +1,232 @@
+// ySIRules - finds Sorting and Icons item rules that can never match and writes the rule files without them
+//
+// usage: ySIRules <json dir or files...> [--out <dir>]
+//
+// reads the rule files the way the loader does, orders every item rule by priority, file name and position, and
+// reports each rule an earlier one covers: every form the later rule can match is matched by the earlier one first.
+// With --out, every input file is written there with its shadowed rules dropped, ready to replace the originals in
+// menus\ySI, so the game never evaluates them and bPruneRules can stay off. Only what the JSON says is used, forms
+// are never resolved: a condition of the earlier rule must appear in the later one with the same or a narrower value,
+// and a rule naming forms is never taken as covered by a formType, which makes the check miss some rules the in-game
+// bAnalyzeRules finds but never drop one that can still win. Comments in the written files are not kept.
+
+#include <json.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using UInt8 = std::uint8_t;
+using UInt32 = std::uint32_t;
+using SInt32 = std::int32_t;
+
+// the form types the loader picks the rule class by, a rule only reads the conditions of its class
+constexpr UInt32 kFormType_TESObjectARMO	= 0x18;
+constexpr UInt32 kFormType_TESObjectWEAP	= 0x28;
+constexpr UInt32 kFormType_AlchemyItem		= 0x2F;
+
+enum class Kind { Item, Weapon, Armor, Aid };
+
+// conditions matching any one of their values, a rule covers another's when its values are a superset
+const std::unordered_set<std::string> kSetKeys
+{
+	"formType", "weaponSkill", "weaponHandgrip", "weaponAttackAnim", "weaponReloadAnim", "weaponSoundLevel", "weaponType",
+};
+
+// keys that select forms or describe the rule rather than restrict it, handled apart from the conditions
+const std::unordered_set<std::string> kSelectorKeys { "tag", "priority", "mod", "form", "formlist", "repairList" };
+
+struct Rule
+{
+	std::string							file;
+	UInt32								fileIndex;
+	SInt32								priority;
+	std::string							tag;
+	Kind								kind;
+	std::unordered_map<std::string, nlohmann::json>	conditions;
+	std::set<std::pair<std::string, UInt32>>		forms;		// (lowercase mod, form ID) as named, lists unexpanded
+	bool								named = false;
+	UInt32								expand = 0;	// formlist and repairList change what the named forms expand to
+};
+
+std::set<UInt32> GetSet(const nlohmann::json& elem)
+{
+	std::set<UInt32> set;
+	if (!elem.is_array()) set.insert(elem.get<UInt32>());
+	else for (const auto& i : elem) set.insert(i.get<UInt32>());
+	return set;
+}
+
+std::string Lower(std::string string)
+{
+	std::ranges::transform(string, string.begin(), [](const unsigned char c) { return std::tolower(c); });
+	return string;
+}
+
+Kind GetKind(const nlohmann::json& elem)
+{
+	if (!elem.contains("formType")) return Kind::Item;
+	const auto formType = GetSet(elem["formType"]);
+	if (formType.contains(kFormType_TESObjectWEAP)) return Kind::Weapon;
+	if (formType.contains(kFormType_TESObjectARMO)) return Kind::Armor;
+	if (formType.contains(kFormType_AlchemyItem)) return Kind::Aid;
+	return Kind::Item;
+}
+
+// whether the rule class the loader builds reads the key, anything else in the element is ignored by the game
+bool Reads(const Kind kind, const std::string& key)
+{
+	if (key == "formType" || key == "questItem" || key == "miscComponent" || key == "miscProduct") return true;
+	if (key.starts_with("weapon") || key == "ammoMod" || key == "ammoForm") return kind == Kind::Weapon;
+	if (key.starts_with("armor")) return kind == Kind::Armor;
+	if (key.starts_with("aid")) return kind == Kind::Aid;
+	return false;
+}
+
+Rule MakeRule(const std::string& file, const UInt32 fileIndex, const nlohmann::json& elem)
+{
+	Rule rule{ file, fileIndex, elem["priority"].get<SInt32>(), elem["tag"].get<std::string>(), GetKind(elem), {}, {} };
+
+	for (const auto& [key, value] : elem.items())
+		if (!kSelectorKeys.contains(key) && Reads(rule.kind, key)) rule.conditions.emplace(key, value);
+
+	if (elem.contains("mod") && elem.contains("form"))
+	{
+		rule.named = true;
+		if (elem.contains("formlist")) rule.expand |= elem["formlist"].get<UInt8>();
+		if (elem.contains("repairList")) rule.expand |= elem["repairList"].get<UInt8>();
+
+		const auto mod = Lower(elem["mod"].get<std::string>());
+		const auto add = [&](const nlohmann::json& form) { rule.forms.emplace(mod, std::stoul(form.get<std::string>(), nullptr, 16) & 0xFFFFFF); };
+		if (elem["form"].is_array()) for (const auto& form : elem["form"]) add(form);
+		else add(elem["form"]);
+	}
+
+	return rule;
+}
+
+// true when every form the later rule can match satisfies the earlier one too
+bool Covers(const Rule& earlier, const Rule& later)
+{
+	if (earlier.named)
+	{
+		if (!later.named || later.expand != earlier.expand) return false;
+		if (!std::ranges::includes(earlier.forms, later.forms)) return false;
+	}
+
+	for (const auto& [key, value] : earlier.conditions)
+	{
+		const auto iter = later.conditions.find(key);
+		if (iter == later.conditions.end()) return false;
+		if (kSetKeys.contains(key))
+		{
+			if (!std::ranges::includes(GetSet(value), GetSet(iter->second))) return false;
+		}
+		else if (value != iter->second) return false;
+	}
+
+	return true;
+}
+
+const nlohmann::json* GetItems(const nlohmann::json& j)
+{
+	if (const auto iter = j.find("items"); iter != j.end()) return &*iter;
+	if (const auto iter = j.find("tags"); iter != j.end()) return &*iter;
+	return nullptr;
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> args(argv + 1, argv + argc);
+	std::filesystem::path output;
+
+	std::vector<std::filesystem::path> paths;
+	for (UInt32 i = 0; i < args.size(); i++)
+	{
+		if (args[i] == "--out" && i + 1 < args.size()) output = args[++i];
+		else if (std::filesystem::is_directory(args[i]))
+		{
+			for (const auto& entry : std::filesystem::directory_iterator(args[i]))
+				if (entry.is_regular_file() && Lower(entry.path().extension().string()) == ".json") paths.push_back(entry.path());
+		}
+		else paths.emplace_back(args[i]);
+	}
+
+	if (paths.empty())
+	{
+		std::cerr << "usage: ySIRules <json dir or files...> [--out <dir>]\n";
+		return 1;
+	}
+
+	std::unordered_map<std::string, nlohmann::json> documents;
+	std::vector<Rule> rules;
+	for (const auto& path : paths)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		const std::string buffer{ std::istreambuf_iterator(stream), std::istreambuf_iterator<char>() };
+
+		const auto file = path.filename().string();
+		auto& j = documents[file] = nlohmann::json::parse(buffer, nullptr, false, true);
+		if (j.is_discarded())
+		{
+			std::cerr << path.string() << ": not valid JSON, skipped\n";
+			continue;
+		}
+
+		const auto items = GetItems(j);
+		if (!items || !items->is_array()) continue;
+		UInt32 index = 0;
+		for (const auto& elem : *items)
+			if (elem.is_object() && elem.contains("tag") && elem.contains("priority")) rules.push_back(MakeRule(file, index++, elem));
+			else index++;
+	}
+
+	// the order the loader evaluates rules in
+	std::ranges::stable_sort(rules, [](const Rule& lhs, const Rule& rhs)
+	{
+		if (lhs.priority != rhs.priority) return lhs.priority > rhs.priority;
+		if (lhs.file != rhs.file) return lhs.file < rhs.file;
+		return lhs.fileIndex < rhs.fileIndex;
+	});
+
+	std::unordered_map<std::string, std::unordered_set<UInt32>> shadowed;
+	UInt32 count = 0;
+	for (UInt32 i = 1; i < rules.size(); i++)
+		for (UInt32 j = 0; j < i; j++)
+			if (Covers(rules[j], rules[i]))
+			{
+				std::cout << "rule '" << rules[i].tag << "' (" << rules[i].file << ":" << rules[i].fileIndex << ") is shadowed by '"
+					<< rules[j].tag << "' (" << rules[j].file << ":" << rules[j].fileIndex << ")\n";
+				shadowed[rules[i].file].insert(rules[i].fileIndex);
+				count++;
+				break;
+			}
+
+	std::cout << rules.size() << " item rules, " << count << " shadowed\n";
+	if (output.empty()) return 0;
+
+	std::filesystem::create_directories(output);
+	for (auto& [file, j] : documents)
+	{
+		if (j.is_discarded()) continue;
+		if (const auto dropped = shadowed.find(file); dropped != shadowed.end())
+		{
+			auto& items = j.contains("items") ? j["items"] : j["tags"];
+			nlohmann::json kept = nlohmann::json::array();
+			for (UInt32 i = 0; i < items.size(); i++) if (!dropped->second.contains(i)) kept.push_back(std::move(items[i]));
+			items = std::move(kept);
+		}
+		std::ofstream(output / file, std::ios::binary | std::ios::trunc) << j.dump(1, '\t') << '\n';
+	}
+
+	return 0;
+}
@@ -200,8 +200,7 @@ namespace UserInterface::LootMenu
 			Float64 x = 0;
 
 			tiles = 0;
-			const auto fontManager = FontManager::GetSingleton();
-			const auto font = tileMain->Get("_Font");
+			const auto font = static_cast<UInt32>(tileMain->Get("_Font"));
 
 			for (const auto fst : tileMain->GetChild("JLMContainer")->children)
 			{
@@ -228,7 +227,7 @@ namespace UserInterface::LootMenu
 				fst->Set("_Equip", snd->GetEquipped());
 
 				const auto category = SortingIcons::Icon::Get(SortingIcons::Item::Get(snd->form->TryGetREFRParent()));
-				if (category->IsValid() && !category->filename.empty())
+				if (category && category->IsValid() && !category->filename.empty())
 				{
 					fst->Set("_Icon", true);
 					fst->Set("_IconFilename", category->filename);
@@ -245,11 +244,11 @@ namespace UserInterface::LootMenu
 
 				const auto wrapWidth = fst->GetChild("ButtonText")->Get(kTileValue_wrapwidth);
 
-				const auto stringDimensions = fontManager->GetStringDimensions(string.c_str(), font, wrapWidth);
+				const auto stringDimensions = TextDimensions::Get(string.c_str(), font, wrapWidth);
 
-				const auto height = indentTextY + stringDimensions->y;
+				const auto height = indentTextY + stringDimensions.y;
 
-				x = max(x, stringDimensions->x + fst->Get("_TextWidth"));
+				x = max(x, stringDimensions.x + fst->Get("_TextWidth"));
 
 				if (y + height > heightMax - 3 * indentItem) break;
 				y += height;
@@ -341,7 +340,8 @@ namespace UserInterface::LootMenu
 				if (const auto script = container->baseForm->GetScript())
 					shouldCheckRecursively = script->refID == formVendorScript->refID;
 				items = container->GetAllItems(shouldCheckRecursively);
-				ra::sort(items, CompareItems);
+				if (SortingIcons::enable && SortingIcons::bSort) SortingIcons::Sorting::Sort(items);
+				else ra::sort(items, CompareItems);
 			}
 
 			if (hidePrompt)
@@ -847,6 +847,7 @@ namespace UserInterface::LootMenu
 
 		deferredInit.emplace_back(DeferredInit);
 		mainLoopDoOnce.emplace_back(MainLoopDoOnce);
+		postLoadGame.emplace_back(TextDimensions::Flush);
 		HandleINI();
 	}
 }
\ No newline at end of file
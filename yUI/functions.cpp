@@ -1,11 +1,13 @@
 #include <functions.h>
 #include <main.h>
 
+#include <list>
 #include <unordered_set>
 
 #include "dinput8.hpp"
 #include "GameData.h"
 #include "Menu.h"
+#include "InterfaceManager.h"
 
 
 namespace CraftingComponents
@@ -29,6 +31,68 @@ namespace CraftingComponents
 	bool IsProduct(TESForm* form) { return g_Products.contains(form); }
 }
 
+namespace TextDimensions
+{
+	// the index keys view the strings owned by the list nodes, so a lookup only hashes the caller's string
+	struct Key
+	{
+		std::string_view	string;
+		UInt32				font;
+		Float32				wrapwidth;
+
+		bool operator==(const Key&) const = default;
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const
+		{
+			return std::hash<std::string_view>()(key.string) ^ key.font * 0x9E3779B1u ^ std::hash<Float32>()(key.wrapwidth);
+		}
+	};
+
+	struct Entry
+	{
+		std::string		string;
+		UInt32			font;
+		Float32			wrapwidth;
+		NiPoint2		dimensions;
+	};
+
+	constexpr UInt32 kCapacity = 512;
+
+	std::list<Entry> entries;	// most recently used first
+	std::unordered_map<Key, decltype(entries)::iterator, KeyHash> index;
+
+	NiPoint2 Get(const char* string, UInt32 font, Float32 wrapwidth)
+	{
+		if (const auto iter = index.find(Key{ string, font, wrapwidth }); iter != index.end())
+		{
+			entries.splice(entries.begin(), entries, iter->second);
+			return iter->second->dimensions;
+		}
+
+		const auto dimensions = FontManager::GetSingleton()->GetStringDimensions(string, font, wrapwidth);
+		entries.push_front({ string, font, wrapwidth, NiPoint2(dimensions->x, dimensions->y) });
+		const auto& entry = entries.front();
+		index.emplace(Key{ entry.string, font, wrapwidth }, entries.begin());
+
+		if (entries.size() > kCapacity)
+		{
+			const auto& last = entries.back();
+			index.erase(Key{ last.string, last.font, last.wrapwidth });
+			entries.pop_back();
+		}
+		return entry.dimensions;
+	}
+
+	void Flush()
+	{
+		index.clear();
+		entries.clear();
+	}
+}
+
 namespace HideInfoPrompt
 {
 	UInt32 shouldHide = 0;
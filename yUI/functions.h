@@ -15,6 +15,13 @@ namespace HideInfoPrompt
 	void Update();
 }
 
+// string sizes from the font manager, remembered per font and wrap width for the most recently measured strings
+namespace TextDimensions
+{
+	NiPoint2 Get(const char* string, UInt32 font, Float32 wrapwidth);
+	void Flush();
+}
+
 TESForm* GetRefFromString(char*, char*);
 
 bool HasBaseEffectChangesAV(TESForm*, int);
@@ -36,6 +36,14 @@ void MessageHandler(NVSEMessagingInterface::Message* msg)
 		for (const auto& i : mainLoop) i(); // call all mainloop functions
 
 	}
+	else if (msg->type == NVSEMessagingInterface::kMessage_PostLoadGame)
+	{
+		for (const auto& i : postLoadGame) i(); // call all post load game functions
+	}
+	else if (msg->type == NVSEMessagingInterface::kMessage_ExitGame || msg->type == NVSEMessagingInterface::kMessage_ExitGame_Console)
+	{
+		for (const auto& i : exitGame) i(); // call all exit game functions
+	}
 }
 
 bool NVSEPlugin_Query(const NVSEInterface* nvse, PluginInfo* info)
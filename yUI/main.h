@@ -30,6 +30,8 @@ inline std::vector<void(*)()>		pluginLoad;
 inline std::vector<void(*)()>		deferredInit;
 inline std::vector<void(*)()>		mainLoop;
 inline std::vector<void(*)()>		mainLoopDoOnce;
+inline std::vector<void(*)()>		postLoadGame;
+inline std::vector<void(*)()>		exitGame;
 
 inline std::vector<void(*)()>		onRender;
 inline std::vector<void(*)(Actor*)>	onHit;